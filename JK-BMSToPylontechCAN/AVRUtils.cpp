@@ -312,10 +312,13 @@ uint16_t computeSleepMillis(uint8_t aWatchdogPrescaler) {
  *                           ! I have see + 30 % deviation from nominal WDT clock!
  * @param aAdjustMillis if true, adjust the Arduino internal millis counter the get quite correct millis()
  * results even after sleep, since the periodic 1 ms timer interrupt is disabled while sleeping.
+ * If another interrupt, e.g. a pin change, wakes us up before the watchdog, the time slept is unknown and half of the sleep time is assumed.
  * Interrupts are enabled before sleep!
  * !!! Do not forget to call e.g. noTone() or  Serial.flush(); to wait for the last character to be sent, and/or disable interrupt sources before !!!
+ * @return The milliseconds slept, which are estimated, if we were woken up early
  */
-void sleepWithWatchdog(uint8_t aWatchdogPrescaler, bool aAdjustMillis) {
+uint16_t sleepWithWatchdog(uint8_t aWatchdogPrescaler, bool aAdjustMillis) {
+    uint16_t tNumberOfSleeps = sNumberOfSleeps;
     MCUSR = 0; // Clear MCUSR to enable a correct interpretation of MCUSR after reset
     ADCSRA &= ~ADEN; // disable ADC just before sleep -> saves 200 uA
 
@@ -336,6 +339,11 @@ void sleepWithWatchdog(uint8_t aWatchdogPrescaler, bool aAdjustMillis) {
     wdt_disable(); // Because next interrupt will otherwise lead to a reset, since wdt_enable() sets WDE / Watchdog System Reset Enable
     ADCSRA |= ADEN;
 
+    uint16_t tSleepMillis = computeSleepMillis(aWatchdogPrescaler);
+    if (tNumberOfSleeps == sNumberOfSleeps) {
+        tSleepMillis /= 2; // The watchdog interrupt did not happen, we were woken up early by another interrupt
+    }
+
     /*
      * Since timer clock may be disabled adjust millis only if not slept in IDLE mode (SM2...0 bits are 000)
      */
@@ -346,8 +354,12 @@ void sleepWithWatchdog(uint8_t aWatchdogPrescaler, bool aAdjustMillis) {
 #else
     if (aAdjustMillis && (SMCR & ((_BV(SM1) | _BV(SM0)))) != 0) {
 #endif
-        timer0_millis += computeSleepMillis(aWatchdogPrescaler);
+        uint8_t tSREG = SREG;
+        cli(); // The timer 0 interrupt is running again and modifies timer0_millis too
+        timer0_millis += tSleepMillis;
+        SREG = tSREG;
     }
+    return tSleepMillis;
 }
 
 /*
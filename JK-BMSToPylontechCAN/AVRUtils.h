@@ -49,7 +49,7 @@ extern volatile unsigned long timer0_millis;
 void initSleep(uint8_t tSleepMode);
 void initPeriodicSleepWithWatchdog(uint8_t tSleepMode, uint8_t aWatchdogPrescaler);
 uint16_t computeSleepMillis(uint8_t aWatchdogPrescaler);
-void sleepWithWatchdog(uint8_t aWatchdogPrescaler, bool aAdjustMillis = false);
+uint16_t sleepWithWatchdog(uint8_t aWatchdogPrescaler, bool aAdjustMillis = false);
 extern volatile uint16_t sNumberOfSleeps;
 
 #include <Print.h>
@@ -0,0 +1,54 @@
+/*
+ * HardwareSerialTX.h
+ *
+ * Transmit only replacement for the Arduino Serial object of the ATmega328.
+ * The Arduino HardwareSerial owns the USART RX interrupt vector, so we can not have our own receive ISR, if Serial is used.
+ * This class only implements the interrupt driven TX ring buffer of the Arduino HardwareSerial
+ * and leaves the USART_RX_vect for the application, which receives the JK-BMS reply frame directly into its buffer.
+ *
+ * Must be included directly after #include <Arduino.h>, because it redefines Serial to SerialTX for all following code.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+
+#ifndef _HARDWARE_SERIAL_TX_H
+#define _HARDWARE_SERIAL_TX_H
+
+#include <Print.h>
+
+#define SERIAL_TX_BUFFER_SIZE   64 // Same as Arduino HardwareSerial, must be a power of 2
+
+class HardwareSerialTX: public Print {
+public:
+    void begin(unsigned long aBaudrate);
+    size_t write(uint8_t aByte);
+    using Print::write; // pull in write(str) and write(buf, size) from Print
+    void flush(void);
+    operator bool() {
+        return true;
+    }
+};
+
+void handleSerialTXDataRegisterEmptyInterrupt();
+
+extern HardwareSerialTX SerialTX;
+#define Serial SerialTX // All Serial.print() of the sketch and its libraries now use SerialTX
+
+#endif // _HARDWARE_SERIAL_TX_H
@@ -44,21 +44,30 @@
 
 void requestJK_BMSStatusFrame(SoftwareSerialTX *aSerial, bool aDebugModeActive = false);
 
-void initJKReplyFrameBuffer();
-void printJKReplyFrameBuffer();
+void initJKReplyFrameReceiving();
 
 #define JK_BMS_RECEIVE_OK           0
 #define JK_BMS_RECEIVE_FINISHED     1
 #define JK_BMS_RECEIVE_ERROR        2
-uint8_t readJK_BMSStatusFrameByte();
+extern volatile uint8_t sJKBMSReceiveStatus;
+extern volatile bool sJKBMSByteWasReceived;
+extern volatile uint16_t sJKBMSFrameChecksum;
+extern uint16_t sJKBMSTokenErrorIndex;
+extern uint16_t sJKBMSStaticDataHash;
+void enableJKReplyFrameReceiveInterrupt();
+void handleJKReplyFrameReceivedByte(uint8_t aReceivedByte);
+uint8_t checkJK_BMSStatusFrame();
+void useReceivedJKReply();
+void storeJKReplyForChangeDetection();
+bool checkJKStaticDataChange();
 void fillJKConvertedCellInfo();
 void fillJKComputedData();
 
 extern const uint8_t sSOCThresholdForForceCharge;
 
-extern uint16_t sReplyFrameBufferIndex;            // Index of next byte to write to array, thus starting with 0.
-extern uint8_t JKReplyFrameBuffer[350];            // The raw big endian data as received from JK BMS
-extern struct JKReplyStruct *sJKFAllReplyPointer;
+extern volatile uint16_t sReplyFrameIndex;         // Index of the byte received next, thus starting with 0.
+extern struct JKReplyStruct *sJKFAllReplyPointer;  // The decoded little endian data of the last frame
+extern struct JKLastReplyStruct lastJKReply;       // For detecting changes
 extern bool sJKBMSFrameHasTimeout; // For sending CAN data
 extern struct JKConvertedCellInfoStruct JKConvertedCellInfo;  // The converted little endian cell voltage data
 extern struct JKComputedDataStruct JKComputedData;        // All derived converted and computed data useful for display
@@ -83,10 +92,11 @@ void myPrintln(const __FlashStringHelper *aPGMString, uint16_t a16BitValue);
 void myPrint(const __FlashStringHelper *aPGMString, uint16_t a16BitValue);
 void myPrintln(const __FlashStringHelper *aPGMString, int16_t a16BitValue);
 void myPrint(const __FlashStringHelper *aPGMString, int16_t a16BitValue);
-void myPrintlnSwap(const __FlashStringHelper *aPGMString, uint16_t a16BitValue);
-void myPrintlnSwap(const __FlashStringHelper *aPGMString, int16_t a16BitValue);
-void myPrintSwap(const __FlashStringHelper *aPGMString, int16_t a16BitValue);
-void myPrintlnSwap(const __FlashStringHelper *aPGMString, uint32_t a32BitValue);
+void myPrint(const __FlashStringHelper *aPGMString, uint32_t a32BitValue);
+void myPrintln(const __FlashStringHelper *aPGMString, uint32_t a32BitValue);
+#if defined(USE_FIXED_POINT)
+void printHundredths(Print *aPrint, int32_t aValueInHundredths, uint8_t aNumberOfDecimalPlaces);
+#endif
 
 void computeUpTimeString();
 void printJKStaticInfo();
@@ -97,6 +107,29 @@ void handleAndPrintAlarmInfo();
 #define JK_BMS_FRAME_TRAILER_LENGTH             9
 #define JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH  (JK_BMS_FRAME_HEADER_LENGTH + 1) // +1 for token 0x79
 #define MINIMAL_JK_BMS_FRAME_LENGTH             19
+#define MAXIMUM_JK_BMS_FRAME_LENGTH             348 // Longest frame seen is 291 bytes for 16 cells
+
+/*
+ * Info for decoding the token value pairs 0x80 to 0xC0 of the JK reply
+ */
+#define JK_BMS_FIRST_TOKEN              0x80
+#define JK_BMS_LAST_TOKEN               0xC0
+#define JK_TOKEN_LENGTH_MASK            0x1F
+#define JK_TOKEN_IS_STRING_FLAG         0x80 // Value is a string, which is terminated with '\0' in JKReplyStruct
+#define JK_TOKEN_IS_TEMPERATURE_FLAG    0x40 // Value is converted by getJKTemperature()
+#define JK_TOKEN_IS_CURRENT_FLAG        0x20 // Value is converted by getCurrent()
+#define JK_TOKEN_IS_NOT_STORED_OFFSET   0xFF // Value is skipped
+/*
+ * Tokens 0x8E to 0xBA contain the configuration of the BMS, except 0xB6 SystemWorkingMinutes.
+ * They are hashed while decoding, to detect configuration changes.
+ */
+#define JK_BMS_FIRST_STATIC_TOKEN       0x8E
+#define JK_BMS_LAST_STATIC_TOKEN        0xBA
+#define JK_BMS_SYSTEM_WORKING_MINUTES_TOKEN 0xB6
+struct JKTokenInfoStruct {
+    uint8_t LengthAndFlags;         // Length of value, 0 for undefined tokens
+    uint8_t OffsetInReplyStruct;    // Offset of the value in JKReplyStruct
+};
 
 /*
  * All 16 and 32 bit values are stored byte swapped, i.e. MSB is stored in lower address.
@@ -139,62 +172,115 @@ struct JKConvertedCellInfoStruct {
 /*
  * Arrays of counters, which count the times, a cell has minimal or maximal voltage
  * To identify runaway cells
+ * The percentages are only computed for display by getCellStatisticsPercentage()
  */
 uint16_t CellMinimumArray[MAXIMUM_NUMBER_OF_CELLS];
 uint16_t CellMaximumArray[MAXIMUM_NUMBER_OF_CELLS];
-uint8_t CellMinimumPercentageArray[MAXIMUM_NUMBER_OF_CELLS];
-uint8_t CellMaximumPercentageArray[MAXIMUM_NUMBER_OF_CELLS];
-#define MINIMUM_BALANCING_COUNT_FOR_DISPLAY         60 //  120 seconds / 2 minutes of balancing
-uint32_t sBalancingCount;            // Count of active balancing in SECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS (2 seconds) units
+#define MILLISECONDS_PER_CELL_STATISTICS_COUNT      2000 // The arrays have only 16 bit
+#define CELL_STATISTICS_COUNT_FOR_SCALING   (60UL * 60UL * 24UL * 1000UL / MILLISECONDS_PER_CELL_STATISTICS_COUNT) // one day
+#define MINIMUM_CELL_STATISTICS_SUM_FOR_PERCENTAGE  60 // We demand 2 minutes of balancing as minimum
+uint32_t getCellStatisticsSum(uint16_t *aCellStatisticsArray);
+uint8_t getCellStatisticsPercentage(uint16_t aCellStatisticsCount, uint32_t aCellStatisticsSum);
+
+/*
+ * Time based statistics. Each reply accounts for the milliseconds elapsed since the last reply and not for one request period,
+ * so the results are independent of the polling rate, of sleeping and of single missed replies.
+ */
+#if !defined(MAXIMUM_MILLISECONDS_FOR_STATISTICS)
+#define MAXIMUM_MILLISECONDS_FOR_STATISTICS         25000 // Longer gaps between 2 replies, e.g. if BMS was switched off, are not counted. 2 * 10 s maximum request period + reply time.
+#endif
+struct StatisticsTimeStruct {
+    uint32_t Units;             // Accumulated time in units of the aMillisPerUnit parameter of addStatisticsMillis()
+    uint16_t RemainderMillis;   // Milliseconds not yet accumulated to Units
+};
+uint16_t getStatisticsMillisSinceLastReply();
+uint16_t addStatisticsMillis(struct StatisticsTimeStruct *aStatisticsTime, uint16_t aMillis, uint16_t aMillisPerUnit);
+struct StatisticsTimeStruct sCellStatisticsTime;    // Balancing time in MILLISECONDS_PER_CELL_STATISTICS_COUNT units
+struct StatisticsTimeStruct sBalancingTime;         // Balancing time in seconds
+#define MINIMUM_BALANCING_SECONDS_FOR_DISPLAY       120 // 2 minutes of balancing
 
 /*
  * This structure contains all converted and computed data useful for display
  */
+/*
+ * Values derived from JKReplyStruct and JKConvertedCellInfoStruct.
+ * Values available in JKReplyStruct are not duplicated here.
+ */
 struct JKComputedDataStruct {
-    int16_t TemperaturePowerMosFet;     // Degree Celsius
-    int16_t TemperatureSensor1;
-    int16_t TemperatureSensor2;
-    int16_t TemperatureMaximum;         // Computed value
+    int16_t TemperatureMaximum;         // Degree Celsius, maximum of power MosFet and sensor temperatures
 
-    uint16_t TotalCapacityAmpereHour;
     uint16_t RemainingCapacityAmpereHour; // Computed value
-    uint16_t BatteryFullVoltage10Millivolt; // Computed by BMS. ActualNumberOfCellInfoEntries *  CellOvervoltageProtectionMillivolt
-    uint16_t BatteryVoltage10Millivolt;
+#if defined(USE_FIXED_POINT)
+    uint16_t BatteryVoltage10Millivolt;     // Copy of Battery10Millivolt
+    int16_t BatteryLoadCurrent10Milliampere; // Copy of Battery10MilliAmpere, Charging is positive discharging is negative
+#else
     float BatteryVoltageFloat;          // Volt
-    int16_t Battery10MilliAmpere;       // Charging is positive discharging is negative
     float BatteryLoadCurrentFloat;      // Ampere
+#endif
     int16_t BatteryLoadPower;           // Watt Computed value, Charging is positive discharging is negative
     bool BMSIsStarting;                 // True if SOC and Cycles are both 0, for around 16 seconds during JK-BMS startup.
     //added by Ngoc
     uint8_t ActualNumberOfCellInfoEntries;     // Use for computation of the fake SOC 
-    uint8_t BatteryType;                // retaining battery 
     uint16_t MinimumCellMillivolt;      // To report Inverter on the data
     uint16_t MaximumCellMillivolt;      // To report Inverter on the data
+    uint16_t AverageCellMillivolt;      // For computation of the fake SOC
     uint8_t SOCPercent;                 // To report mapped SOC
     uint16_t Cycles;                    // To report total cycle of the batteries
 };
 
 /*
- * Only for documentation
+ * Alarm and status bits of token 0x8B and 0x8C
  */
+union JKAlarmUnion {
+    uint16_t AlarmsAsWord;
+    struct {
+        // Low byte of alarms
+        bool LowCapacityAlarm :1;               // 0x0001
+        bool PowerMosFetOvertemperatureAlarm :1;
+        bool ChargeOvervoltageAlarm :1;         // 0x0004 This happens quite often, if battery charging is approaching 100 %
+        bool DischargeUndervoltageAlarm :1;
+        bool Sensor1Or2OvertemperatureAlarm :1; // 0x0010 - Affects the charging/discharging MosFet state, not the enable flags
+        /*
+         * Set with delay of (Dis)ChargeOvercurrentDelaySeconds / "OCP Delay(S)" seconds initially or on retry.
+         * Retry is done after "OCPR Time(S)"
+         */
+        bool ChargeOvercurrentAlarm :1;  // 0x0020 - Set with delay of ChargeOvercurrentDelaySeconds seconds initially or on retry
+        bool DischargeOvercurrentAlarm :1; // 0x0040 - Set with delay of DischargeOvercurrentDelaySeconds seconds initially or on retry
+        bool CellVoltageDifferenceAlarm :1;     // 0x0080
+
+        // High byte of alarms
+        bool Sensor2OvertemperatureAlarm :1;    // 0x0100
+        bool Sensor1Or2UndertemperatureAlarm :1; // 0x0200 Disables charging, but Has no effect on discharging
+        bool CellOvervoltageAlarm :1;           // 0x0400
+        bool CellUndervoltageAlarm :1;
+        bool _309_A_ProtectionAlarm :1;         // 0x1000
+        bool _309_B_ProtectionAlarm :1;
+        bool Reserved1Alarm :1;                 // Two highest bits are reserved
+        bool Reserved2Alarm :1;
+    } AlarmBits;
+};
+
 union BMSStatusUnion {
     uint16_t StatusAsWord;
     struct {
-        uint8_t ReservedStatusHighByte;         // This is the low byte of StatusAsWord, but it was sent as high byte of status
         bool ChargeMosFetActive :1;             // 0x01 // Is disabled e.g. on over current or temperature
         bool DischargeMosFetActive :1;          // 0x02 // Is disabled e.g. on over current or temperature
         bool BalancerActive :1;                 // 0x04
         bool BatteryDown :1;                    // 0x08
         uint8_t ReservedStatus :4;
+        uint8_t ReservedStatusHighByte;
     } StatusBits;
 };
 
 /*
  * Structure representing the semantic of the JK reply, except cell voltage info.
  *
- * All 16 and 32 bit values in this structure are filled with big endian by the JK protocol i.e. the higher byte is located at the lower memory address.
- * AVR and others are using little endian i.e. the lower byte is located at the lower memory address.
- * !!! => all 16 and 32 bit values in this structure must be "swapped" before interpreting them!!!
+ * The JK reply consists of a token byte followed by a value with a fixed length for each token, see JKTokenInfoArray[].
+ * All 16 and 32 bit values are sent as big endian by the JK protocol i.e. the higher byte is located at the lower memory address.
+ * They are decoded by the receive ISR byte by byte into this structure, which contains the values in native (little) endian format
+ * and zero terminated strings. Temperatures and current are converted to signed values.
+ * So all values can be used directly by all consumers.
+ * Values of tokens, which are not contained in the reply, keep the value of the last frame.
  *
  * All temperatures are in degree celsius.
  * Power MosFet temperature sensor is originally named PowerTube
@@ -205,203 +291,117 @@ union BMSStatusUnion {
  */
 #define NUMBER_OF_DEFINED_ALARM_BITS    14
 struct JKReplyStruct {
-    uint8_t TokenTemperaturePowerMosFet;    // 0x80
-    uint16_t TemperaturePowerMosFet;        // 99 = 99 degree Celsius, 100 = 100, 101 = -1, 140 = -40
-    uint8_t TokenTemperatureSensor1;        // 0x81 TemperatureSensor1
-    uint16_t TemperatureSensor1;            // originally named Battery Box, the outmost sensor beneath the led
-    uint8_t TokenTemperatureSensor2;        // 0x82
-    uint16_t TemperatureSensor2;            // originally named Battery, the inner sensor beneath the battery+
-    uint8_t TokenVoltage;                   // 0x83
-    uint16_t Battery10Millivolt;
-    uint8_t TokenCurrent;                   // 0x84
+    int16_t TemperaturePowerMosFet;         // 0x80 Sent as 99 = 99 degree Celsius, 100 = 100, 101 = -1, 140 = -40
+    int16_t TemperatureSensor1;             // 0x81 originally named Battery Box, the outmost sensor beneath the led
+    int16_t TemperatureSensor2;             // 0x82 originally named Battery, the inner sensor beneath the battery+
+    uint16_t Battery10Millivolt;            // 0x83
     // Current values start with 200mA at 240 mA real current -> 410 -> 620 -> 830mA@920mA real -> 1030@1080mA real -> 1.33 => Resolution is 0.21A
-    uint16_t Battery10MilliAmpere;          // Highest bit: 0=Discharge, 1=Charge -> depends on ProtocolVersionNumber
-    uint8_t TokenSOCPercent;                // 0x85
-    uint8_t SOCPercent;                     // 0-100%
-    uint8_t TokenNumberOfTemperatureSensors; // 0x86
-    uint8_t NumberOfTemperatureSensors;     // 2
-    uint8_t TokenCycles;                    // 0x87
-    uint16_t Cycles;
-    uint8_t TokenTotalBatteryCycleCapacity; // 0x89
-    uint32_t TotalBatteryCycleCapacity;     // Ah
-
-    uint8_t TokenNumberOfBatteryCells;      // 0x8A
-    uint16_t NumberOfBatteryCells;
-    uint8_t TokenBatteryAlarm;              // 0x8B
-
-    union {
-        uint16_t AlarmsAsWord;
-        struct {
-            // High byte of alarms
-            bool Sensor2OvertemperatureAlarm :1;    // 0x0100
-            bool Sensor1Or2UndertemperatureAlarm :1; // 0x0200 Disables charging, but Has no effect on discharging
-            bool CellOvervoltageAlarm :1;           // 0x0400
-            bool CellUndervoltageAlarm :1;
-            bool _309_A_ProtectionAlarm :1;         // 0x1000
-            bool _309_B_ProtectionAlarm :1;
-            bool Reserved1Alarm :1;                 // Two highest bits are reserved
-            bool Reserved2Alarm :1;
-
-            // Low byte of alarms
-            bool LowCapacityAlarm :1;               // 0x0001
-            bool PowerMosFetOvertemperatureAlarm :1;
-            bool ChargeOvervoltageAlarm :1;         // 0x0004 This happens quite often, if battery charging is approaching 100 %
-            bool DischargeUndervoltageAlarm :1;
-            bool Sensor1Or2OvertemperatureAlarm :1; // 0x0010 - Affects the charging/discharging MosFet state, not the enable flags
-            /*
-             * Set with delay of (Dis)ChargeOvercurrentDelaySeconds / "OCP Delay(S)" seconds initially or on retry.
-             * Retry is done after "OCPR Time(S)"
-             */
-            bool ChargeOvercurrentAlarm :1;  // 0x0020 - Set with delay of ChargeOvercurrentDelaySeconds seconds initially or on retry
-            bool DischargeOvercurrentAlarm :1; // 0x0040 - Set with delay of DischargeOvercurrentDelaySeconds seconds initially or on retry
-            bool CellVoltageDifferenceAlarm :1;     // 0x0080
-        } AlarmBits;
-    } AlarmUnion;
-
-    uint8_t TokenBatteryStatus;                     // 0x8C
-    union {
-        uint16_t StatusAsWord;
-        struct {
-            uint8_t ReservedStatusHighByte;         // This is the low byte of StatusAsWord, but it was sent as high byte of status
-            bool ChargeMosFetActive :1;             // 0x01 // Is disabled e.g. on over current or temperature
-            bool DischargeMosFetActive :1;          // 0x02 // Is disabled e.g. on over current or temperature
-            bool BalancerActive :1;                 // 0x04
-            bool BatteryDown :1;                    // 0x08
-            uint8_t ReservedStatus :4;
-        } StatusBits;
-    } BMSStatus;
-
-    uint8_t TokenBatteryOvervoltageProtection10Millivolt; // 0x8E
-    uint16_t BatteryOvervoltageProtection10Millivolt;   // 1000 to 15000 = # of cells * CellOvervoltageProtectionMillivolt
-    uint8_t TokenBatteryUndervoltageProtection10Millivolt; // 0x8F
-    uint16_t BatteryUndervoltageProtection10Millivolt;  // 1000 to 15000
-    uint8_t TokenCellOvervoltageProtectionMillivolt;    // 0x90
-    uint16_t CellOvervoltageProtectionMillivolt;        // 1000 to 4500
-    uint8_t TokenCellOvervoltageRecoveryMillivolt;      // 0x91
-    uint16_t CellOvervoltageRecoveryMillivolt;          // 1000 to 4500
-    uint8_t TokenCellOvervoltageDelaySeconds;           // 0x92
-    uint16_t CellOvervoltageDelaySeconds;               // 1 to 60
-    uint8_t TokenCellUndervoltageProtectionMillivolt;   // 0x93
-    uint16_t CellUndervoltageProtectionMillivolt;
-    uint8_t TokenCellUndervoltageRecoveryMillivolt;     // 0x94
-    uint16_t CellUndervoltageRecoveryMillivolt;
-    uint8_t TokenCellUndervoltageDelaySeconds;          // 0x95
-    uint16_t CellUndervoltageDelaySeconds;
-
-    uint8_t TokenVoltageDifferenceProtectionMillivolt;  // 0x96
-    uint16_t VoltageDifferenceProtectionMillivolt;      // 0 to 100
-
-    uint8_t TokenDischargeOvercurrentProtectionAmpere;  // 0x97
-    uint16_t DischargeOvercurrentProtectionAmpere;      // 1 to 1000
-    uint8_t TokenDischargeOvercurrentDelaySeconds;      // 0x98
-    uint16_t DischargeOvercurrentDelaySeconds;          // 1 to 60
-    uint8_t TokenChargeOvercurrentProtectionAmpere;     // 0x99
-    uint16_t ChargeOvercurrentProtectionAmpere;         // 1 to 1000
-    uint8_t TokenChargeOvercurrentDelaySeconds;         // 0x9A
-    uint16_t ChargeOvercurrentDelaySeconds;             // 1 to 60
-
-    uint8_t TokenBalancingStartVoltage;                 // 0x9B
-    uint16_t BalancingStartMillivolt;                   // 2000 to 4500
-    uint8_t TokenBalancingStartDifferentialVoltage;     // 0x9C
-    uint16_t BalancingStartDifferentialMillivolt;       // 10 to 1000
-    uint8_t TokenBalancingState;                        // 0x9D
-    uint8_t BalancingIsEnabled;                         // 0=off 1=on
-
-    uint8_t TokenPowerMosFetTemperatureProtection;      // 0x9E
-    uint16_t PowerMosFetTemperatureProtection;          // 0 to 100
-    uint8_t TokenPowerMosFetRecoveryTemperature;        // 0x9F
-    uint16_t PowerMosFetRecoveryTemperature;            // 0 to 100
-    uint8_t TokenSensor1TemperatureProtection;          // 0xA0
-    uint16_t Sensor1TemperatureProtection;              // 40 to 100
-    uint8_t TokenSensor1RecoveryTemperature;            // 0xA1
-    uint16_t Sensor1RecoveryTemperature;                // 40 to 100
-
-    uint8_t TokenBatteryDifferenceTemperatureProtection; // 0xA2
-    uint16_t BatteryDifferenceTemperatureProtection;    // 2 to 20
-
-    uint8_t TokenChargeOvertemperatureProtection;       // 0xA3
-    uint16_t ChargeOvertemperatureProtection;           // 0 to 100
-    uint8_t TokenDischargeOvertemperatureProtection;    // 0xA4
-    uint16_t DischargeOvertemperatureProtection;        // 0 to 100
-
-    uint8_t TokenChargeUndertemperatureProtection;      // 0xA5
-    int16_t ChargeUndertemperatureProtection;           // -45 to 25
-    uint8_t TokenChargeRecoveryUndertemperature;        // 0xA6
-    int16_t ChargeRecoveryUndertemperature;             // -45 to 25
-    uint8_t TokenDischargeUndertemperatureProtection;   // 0xA7
-    int16_t DischargeUndertemperatureProtection;        // -45 to 25
-    uint8_t TokenDischargeRecoveryUndertemperature;     // 0xA8
-    int16_t DischargeRecoveryUndertemperature;          // -45 to 25
-
-    uint8_t TokenBatteryCellCount;              // 0xA9
-    uint8_t BatteryCellCount;                   // 3 to 32
-
-    uint8_t TokenTotalCapacity;                 // 0xAA
-    uint32_t TotalCapacityAmpereHour;           // Ah
-
-    uint8_t TokenChargeMosFetState;             // 0xAB
-    uint8_t ChargeIsEnabled;                    // 0=off 1=on
-    uint8_t TokenDischargeMosFetState;          // 0xAC
-    uint8_t DischargeIsEnabled;                 // 0=off 1=on
-
-    uint8_t TokenCurrentCalibration;            // 0xAD
-    uint16_t CurrentCalibrationMilliampere;     // 100 to 20000 mA - 1039 for my BMS (factory calibration?)
-
-    uint8_t TokenBoardAddress;                  // 0xAE
-    uint8_t BoardAddress;                       // 1 -used for cascading
-
-    uint8_t TokenBatteryType;                   // 0xAF
-    uint8_t BatteryType;                       // 0 (lithium iron phosphate), 1 (ternary), 2 (lithium titanate), value is constant 1
-
-    uint8_t TokenSleepWaitingTime;              // 0xB0
-    uint16_t SleepWaitingTimeSeconds;           //
-
-    uint8_t TokenLowCapacityAlarm;              // 0xB1
-    uint8_t LowCapacityAlarmPercent;            // 0 to 80
-
-    uint8_t TokenModifyParameterPassword;       // 0xB2
-    char ModifyParameterPassword[10];           // "123456" - can be HEX
-
-    uint8_t TokenDedicatedChargerSwitchState;   // 0xB3
-    uint8_t DedicatedChargerSwitchIsActive;     // 0=off 1=on
-
-    uint8_t TokenDeviceIdString;                // 0xB4
-    char DeviceIdString[8];                // First 8 characters of the manufacturer id entered in the app field "User Private Data"
-
-    uint8_t TokenManufacturerDate;              // 0xB5
-    char ManufacturerDate[4];                   // "YYMM" - Date of first connection with app
-
-    uint8_t TokenSystemWorkingMinutes;          // 0xB6
-    uint32_t SystemWorkingMinutes;              // Minutes
-
-    uint8_t TokenSoftwareVersionNumber;         // 0xB7
-    char SoftwareVersionNumber[15];             // "11.XW_S11.26___" or from documentation: "NW_1_0_0_200428"
-
-    uint8_t TokenStartCurrentCalibration;       // 0xB8
-    uint8_t StartCurrentCalibration;            // 0=stop 1=start
-
-    uint8_t TokenActualBatteryCapacity;         // 0xB9
-    uint32_t ActualBatteryCapacityAmpereHour;   // Ah
-
-    uint8_t TokenManufacturerId;                // 0xBA
-    char ManufacturerId[24]; // First 12 characters of the 13 characters manufacturer id entered in the app field "User Private Data"
-                             // followed by "JK_B2A20S20P" for my balancer
-
-//    uint8_t TokenRestartSystem;                 // 0xBB
-//    uint8_t RestartSystem;                      // 0=stop 1=restart
-//    uint8_t TokenFactoryDataReset;              // 0xBC
-//    uint8_t FactoryDataReset;                   // 0=stop 1=reset
-//    uint8_t TokenRemoteUpgradeIdentification;   // 0xBD
-//    uint8_t RemoteUpgradeIdentification;        // 0=stop 1=start
-//
-//    uint8_t TokenGPSTurnOffVoltage;             // 0xBE
-//    uint16_t GPSTurnOffVoltageMillivolt;
-//    uint8_t TokenGPSRecoveryVoltage;            // 0xBF
-//    uint16_t GPSRecoveryVoltageMillivolt;
-
-    uint8_t TokenProtocolVersionNumber;         // 0xC0
-    uint8_t ProtocolVersionNumber;              // 00, 01 -> Redefine the 0x84 current data as 10 mA,
+    int16_t Battery10MilliAmpere;           // 0x84 Charging is positive discharging is negative. Sent with highest bit: 0=Discharge, 1=Charge -> depends on ProtocolVersionNumber
+    uint8_t SOCPercent;                     // 0x85 0-100%
+    uint8_t NumberOfTemperatureSensors;     // 0x86 2
+    uint16_t Cycles;                        // 0x87
+    uint32_t TotalBatteryCycleCapacity;     // 0x89 Ah
+
+    uint16_t NumberOfBatteryCells;          // 0x8A
+
+    JKAlarmUnion AlarmUnion;                // 0x8B
+
+    BMSStatusUnion BMSStatus;               // 0x8C
+
+    uint16_t BatteryOvervoltageProtection10Millivolt;   // 0x8E 1000 to 15000 = # of cells * CellOvervoltageProtectionMillivolt
+    uint16_t BatteryUndervoltageProtection10Millivolt;  // 0x8F 1000 to 15000
+    uint16_t CellOvervoltageProtectionMillivolt;        // 0x90 1000 to 4500
+    uint16_t CellOvervoltageRecoveryMillivolt;          // 0x91 1000 to 4500
+    uint16_t CellOvervoltageDelaySeconds;               // 0x92 1 to 60
+    uint16_t CellUndervoltageProtectionMillivolt;       // 0x93
+    uint16_t CellUndervoltageRecoveryMillivolt;         // 0x94
+    uint16_t CellUndervoltageDelaySeconds;              // 0x95
+
+    uint16_t VoltageDifferenceProtectionMillivolt;      // 0x96 0 to 100
+
+    uint16_t DischargeOvercurrentProtectionAmpere;      // 0x97 1 to 1000
+    uint16_t DischargeOvercurrentDelaySeconds;          // 0x98 1 to 60
+    uint16_t ChargeOvercurrentProtectionAmpere;         // 0x99 1 to 1000
+    uint16_t ChargeOvercurrentDelaySeconds;             // 0x9A 1 to 60
+
+    uint16_t BalancingStartMillivolt;                   // 0x9B 2000 to 4500
+    uint16_t BalancingStartDifferentialMillivolt;       // 0x9C 10 to 1000
+    uint8_t BalancingIsEnabled;                         // 0x9D 0=off 1=on
+
+    uint16_t PowerMosFetTemperatureProtection;          // 0x9E 0 to 100
+    uint16_t PowerMosFetRecoveryTemperature;            // 0x9F 0 to 100
+    uint16_t Sensor1TemperatureProtection;              // 0xA0 40 to 100
+    uint16_t Sensor1RecoveryTemperature;                // 0xA1 40 to 100
+
+    uint16_t BatteryDifferenceTemperatureProtection;    // 0xA2 2 to 20
+
+    uint16_t ChargeOvertemperatureProtection;           // 0xA3 0 to 100
+    uint16_t DischargeOvertemperatureProtection;        // 0xA4 0 to 100
+
+    int16_t ChargeUndertemperatureProtection;           // 0xA5 -45 to 25
+    int16_t ChargeRecoveryUndertemperature;             // 0xA6 -45 to 25
+    int16_t DischargeUndertemperatureProtection;        // 0xA7 -45 to 25
+    int16_t DischargeRecoveryUndertemperature;          // 0xA8 -45 to 25
+
+    uint8_t BatteryCellCount;                   // 0xA9 3 to 32
+
+    uint32_t TotalCapacityAmpereHour;           // 0xAA Ah
+
+    uint8_t ChargeIsEnabled;                    // 0xAB 0=off 1=on
+    uint8_t DischargeIsEnabled;                 // 0xAC 0=off 1=on
+
+    uint16_t CurrentCalibrationMilliampere;     // 0xAD 100 to 20000 mA - 1039 for my BMS (factory calibration?)
+
+    uint8_t BoardAddress;                       // 0xAE 1 -used for cascading
+
+    uint8_t BatteryType;                        // 0xAF 0 (lithium iron phosphate), 1 (ternary), 2 (lithium titanate), value is constant 1
+
+    uint16_t SleepWaitingTimeSeconds;           // 0xB0
+
+    uint8_t LowCapacityAlarmPercent;            // 0xB1 0 to 80
+
+    char ModifyParameterPassword[10 + 1];       // 0xB2 "123456" - can be HEX
+
+    uint8_t DedicatedChargerSwitchIsActive;     // 0xB3 0=off 1=on
+
+    char DeviceIdString[8 + 1];                 // 0xB4 First 8 characters of the manufacturer id entered in the app field "User Private Data"
+
+    char ManufacturerDate[4 + 1];               // 0xB5 "YYMM" - Date of first connection with app
+
+    uint32_t SystemWorkingMinutes;              // 0xB6 Minutes
+
+    char SoftwareVersionNumber[15 + 1];         // 0xB7 "11.XW_S11.26___" or from documentation: "NW_1_0_0_200428"
+
+    uint8_t StartCurrentCalibration;            // 0xB8 0=stop 1=start
+
+    uint32_t ActualBatteryCapacityAmpereHour;   // 0xB9 Ah
+
+    char ManufacturerId[24 + 1]; // 0xBA First 12 characters of the 13 characters manufacturer id entered in the app field "User Private Data"
+                                 // followed by "JK_B2A20S20P" for my balancer
+
+// Tokens 0xBB to 0xBF are not stored
+//    uint8_t RestartSystem;                      // 0xBB 0=stop 1=restart
+//    uint8_t FactoryDataReset;                   // 0xBC 0=stop 1=reset
+//    uint8_t RemoteUpgradeIdentification;        // 0xBD 0=stop 1=start
+//    uint16_t GPSTurnOffVoltageMillivolt;        // 0xBE
+//    uint16_t GPSRecoveryVoltageMillivolt;       // 0xBF
+
+    uint8_t ProtocolVersionNumber;              // 0xC0 00, 01 -> Redefine the 0x84 current data as 10 mA,
                                                 // with the highest bit being 0 for discharge and 1 for charge
 };
 
+/*
+ * The values of the last frame, which are checked for changes before printing.
+ * A copy of the complete JKReplyStruct would require 168 bytes of RAM.
+ */
+struct JKLastReplyStruct {
+    int16_t TemperaturePowerMosFet;
+    int16_t TemperatureSensor1;
+    int16_t TemperatureSensor2;
+    uint8_t SOCPercent;
+    JKAlarmUnion AlarmUnion;
+    BMSStatusUnion BMSStatus;
+    uint32_t SystemWorkingMinutes;
+};
+
 #endif // _JK_BMS_H
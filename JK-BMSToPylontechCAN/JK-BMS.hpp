@@ -31,7 +31,7 @@
 
 #include "JK-BMS.h"
 
-JKReplyStruct lastJKReply;
+JKLastReplyStruct lastJKReply;
 
 #if defined(DEBUG)
 #define LOCAL_DEBUG
@@ -48,11 +48,25 @@ uint8_t JKRequestStatusFrame[21] = { 0x4E, 0x57 /*4E 57 = StartOfFrame*/, 0x00,
         0x00, 0x00, 0x01, 0x29 /*Checksum, high 2 bytes for checksum not yet enabled -> 0, low 2 Byte for checksum*/};
 uint8_t JKrequestStatusFrameOld[] = { 0xDD, 0xA5, 0x03, 0x00, 0xFF, 0xFD, 0x77 };
 
-uint16_t sReplyFrameBufferIndex = 0;        // Index of next byte to write to array, except for last byte received. Starting with 0.
+volatile uint16_t sReplyFrameIndex = 0;     // Index of the byte received next, except for last byte received. Starting with 0.
 uint16_t sReplyFrameLength;                 // Received length of frame
-uint8_t JKReplyFrameBuffer[350];            // The raw big endian data as received from JK BMS
+uint8_t sReplyFrameLastByte;                // The byte at sReplyFrameIndex, for error messages
+uint8_t sReplyFrameChecksumHighByte;        // Received high byte of checksum
 bool sJKBMSFrameHasTimeout;                 // If true, timeout message or CAN Info page is displayed.
 
+/*
+ * The big endian cell voltages are converted by the receive ISR, since the frame is not stored.
+ * Minimum, maximum and sum of the non zero cell voltages are computed on the fly.
+ */
+uint8_t sReplyCellInfoLength;               // Number of cell info bytes as received at JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH
+uint8_t sReplyCellIndex;                    // Index of cell currently received
+uint8_t sReplyCellByteIndex;                // 0 = cell number, 1 = high byte and 2 = low byte of cell millivolt
+uint16_t sReplyCellMillivoltArray[MAXIMUM_NUMBER_OF_CELLS];
+uint16_t sReplyCellMinimumMillivolt;
+uint16_t sReplyCellMaximumMillivolt;
+uint32_t sReplyCellMillivoltSum;
+uint8_t sReplyNumberOfNonNullCellInfo;
+
 JKConvertedCellInfoStruct JKConvertedCellInfo;  // The converted little endian cell voltage data
 JKComputedDataStruct JKComputedData;            // All derived converted and computed data useful for display
 JKComputedDataStruct lastJKComputedData;        // For detecting changes
@@ -63,9 +77,112 @@ bool sUpTimeStringTenthOfMinuteHasChanged;
 char sLastUpTimeTenthOfMinuteCharacter;     // For detecting changes in string and setting sUpTimeStringTenthOfMinuteHasChanged
 
 /*
- * The JKFrameAllDataStruct starts behind the header + cell data header 0x79 + CellInfoSize + the variable length cell data (CellInfoSize is contained in JKReplyFrameBuffer[12])
+ * The JKReplyStruct is decoded from the token data behind the header + cell data header 0x79 + CellInfoSize + the variable length cell data.
+ * The ISR decodes into the struct of sJKReceiveReplyPointer, while the struct of sJKFAllReplyPointer keeps the data of the last valid frame.
+ * Both pointers are swapped by useReceivedJKReply() if a frame was received completely.
  */
-JKReplyStruct *sJKFAllReplyPointer;
+JKReplyStruct sJKReplyStructs[2];
+JKReplyStruct *sJKFAllReplyPointer = &sJKReplyStructs[0];
+JKReplyStruct *sJKReceiveReplyPointer = &sJKReplyStructs[1];
+
+/*
+ * State of the token decoder
+ */
+uint8_t sJKToken;                   // Token whose value is currently received
+uint8_t sJKTokenLengthAndFlags;     // Of sJKToken
+uint8_t sJKTokenRemainingBytes;     // Bytes of the value not yet received, 0 -> next byte is a token
+uint8_t *sJKTokenValuePointer;      // Destination of the next value byte, NULL if value is not stored
+bool sJKTokenIsStatic;              // sJKToken belongs to the BMS configuration, which is hashed
+uint16_t sJKBMSTokenErrorIndex;     // Index of the first token, which could not be decoded, 0 if all tokens were decoded
+uint8_t sJKBMSTokenErrorByte;       // The token, which could not be decoded
+
+/*
+ * Rotate and xor hash of the static tokens and their values, computed by the receive ISR.
+ * Rotating is bijective, so every single byte change of the configuration changes the hash.
+ */
+uint16_t sJKBMSStaticDataHash;
+uint16_t sLastJKBMSStaticDataHash;
+bool sLastJKBMSStaticDataHashIsValid = false;
+
+/*
+ * Length of the value and offset in JKReplyStruct for each token from 0x80 to 0xC0.
+ * Length 0 marks an undefined token, which stops decoding, since we do not know where the next token starts.
+ */
+#define JK_TOKEN_INFO(aLength, aField)      { (aLength), offsetof(JKReplyStruct, aField) }
+#define JK_TOKEN_INFO_STRING(aLength, aField) { (aLength) | JK_TOKEN_IS_STRING_FLAG, offsetof(JKReplyStruct, aField) }
+#define JK_TOKEN_INFO_TEMPERATURE(aField)   { 2 | JK_TOKEN_IS_TEMPERATURE_FLAG, offsetof(JKReplyStruct, aField) }
+#define JK_TOKEN_INFO_CURRENT(aField)       { 2 | JK_TOKEN_IS_CURRENT_FLAG, offsetof(JKReplyStruct, aField) }
+#define JK_TOKEN_INFO_NOT_STORED(aLength)   { (aLength), JK_TOKEN_IS_NOT_STORED_OFFSET }
+#define JK_TOKEN_INFO_UNDEFINED             { 0, JK_TOKEN_IS_NOT_STORED_OFFSET }
+
+const JKTokenInfoStruct JKTokenInfoArray[JK_BMS_LAST_TOKEN - JK_BMS_FIRST_TOKEN + 1] PROGMEM = {
+        JK_TOKEN_INFO_TEMPERATURE(TemperaturePowerMosFet),          // 0x80
+        JK_TOKEN_INFO_TEMPERATURE(TemperatureSensor1),              // 0x81
+        JK_TOKEN_INFO_TEMPERATURE(TemperatureSensor2),              // 0x82
+        JK_TOKEN_INFO(2, Battery10Millivolt),                       // 0x83
+        JK_TOKEN_INFO_CURRENT(Battery10MilliAmpere),                // 0x84
+        JK_TOKEN_INFO(1, SOCPercent),                               // 0x85
+        JK_TOKEN_INFO(1, NumberOfTemperatureSensors),               // 0x86
+        JK_TOKEN_INFO(2, Cycles),                                   // 0x87
+        JK_TOKEN_INFO_UNDEFINED,                                    // 0x88
+        JK_TOKEN_INFO(4, TotalBatteryCycleCapacity),                // 0x89
+        JK_TOKEN_INFO(2, NumberOfBatteryCells),                     // 0x8A
+        JK_TOKEN_INFO(2, AlarmUnion.AlarmsAsWord),                  // 0x8B
+        JK_TOKEN_INFO(2, BMSStatus.StatusAsWord),                   // 0x8C
+        JK_TOKEN_INFO_UNDEFINED,                                    // 0x8D
+        JK_TOKEN_INFO(2, BatteryOvervoltageProtection10Millivolt),  // 0x8E
+        JK_TOKEN_INFO(2, BatteryUndervoltageProtection10Millivolt), // 0x8F
+        JK_TOKEN_INFO(2, CellOvervoltageProtectionMillivolt),       // 0x90
+        JK_TOKEN_INFO(2, CellOvervoltageRecoveryMillivolt),         // 0x91
+        JK_TOKEN_INFO(2, CellOvervoltageDelaySeconds),              // 0x92
+        JK_TOKEN_INFO(2, CellUndervoltageProtectionMillivolt),      // 0x93
+        JK_TOKEN_INFO(2, CellUndervoltageRecoveryMillivolt),        // 0x94
+        JK_TOKEN_INFO(2, CellUndervoltageDelaySeconds),             // 0x95
+        JK_TOKEN_INFO(2, VoltageDifferenceProtectionMillivolt),     // 0x96
+        JK_TOKEN_INFO(2, DischargeOvercurrentProtectionAmpere),     // 0x97
+        JK_TOKEN_INFO(2, DischargeOvercurrentDelaySeconds),         // 0x98
+        JK_TOKEN_INFO(2, ChargeOvercurrentProtectionAmpere),        // 0x99
+        JK_TOKEN_INFO(2, ChargeOvercurrentDelaySeconds),            // 0x9A
+        JK_TOKEN_INFO(2, BalancingStartMillivolt),                  // 0x9B
+        JK_TOKEN_INFO(2, BalancingStartDifferentialMillivolt),      // 0x9C
+        JK_TOKEN_INFO(1, BalancingIsEnabled),                       // 0x9D
+        JK_TOKEN_INFO(2, PowerMosFetTemperatureProtection),         // 0x9E
+        JK_TOKEN_INFO(2, PowerMosFetRecoveryTemperature),           // 0x9F
+        JK_TOKEN_INFO(2, Sensor1TemperatureProtection),             // 0xA0
+        JK_TOKEN_INFO(2, Sensor1RecoveryTemperature),               // 0xA1
+        JK_TOKEN_INFO(2, BatteryDifferenceTemperatureProtection),   // 0xA2
+        JK_TOKEN_INFO(2, ChargeOvertemperatureProtection),          // 0xA3
+        JK_TOKEN_INFO(2, DischargeOvertemperatureProtection),       // 0xA4
+        JK_TOKEN_INFO(2, ChargeUndertemperatureProtection),         // 0xA5
+        JK_TOKEN_INFO(2, ChargeRecoveryUndertemperature),           // 0xA6
+        JK_TOKEN_INFO(2, DischargeUndertemperatureProtection),      // 0xA7
+        JK_TOKEN_INFO(2, DischargeRecoveryUndertemperature),        // 0xA8
+        JK_TOKEN_INFO(1, BatteryCellCount),                         // 0xA9
+        JK_TOKEN_INFO(4, TotalCapacityAmpereHour),                  // 0xAA
+        JK_TOKEN_INFO(1, ChargeIsEnabled),                          // 0xAB
+        JK_TOKEN_INFO(1, DischargeIsEnabled),                       // 0xAC
+        JK_TOKEN_INFO(2, CurrentCalibrationMilliampere),            // 0xAD
+        JK_TOKEN_INFO(1, BoardAddress),                             // 0xAE
+        JK_TOKEN_INFO(1, BatteryType),                              // 0xAF
+        JK_TOKEN_INFO(2, SleepWaitingTimeSeconds),                  // 0xB0
+        JK_TOKEN_INFO(1, LowCapacityAlarmPercent),                  // 0xB1
+        JK_TOKEN_INFO_STRING(10, ModifyParameterPassword),          // 0xB2
+        JK_TOKEN_INFO(1, DedicatedChargerSwitchIsActive),           // 0xB3
+        JK_TOKEN_INFO_STRING(8, DeviceIdString),                    // 0xB4
+        JK_TOKEN_INFO_STRING(4, ManufacturerDate),                  // 0xB5
+        JK_TOKEN_INFO(4, SystemWorkingMinutes),                     // 0xB6
+        JK_TOKEN_INFO_STRING(15, SoftwareVersionNumber),            // 0xB7
+        JK_TOKEN_INFO(1, StartCurrentCalibration),                  // 0xB8
+        JK_TOKEN_INFO(4, ActualBatteryCapacityAmpereHour),          // 0xB9
+        JK_TOKEN_INFO_STRING(24, ManufacturerId),                   // 0xBA
+        JK_TOKEN_INFO_NOT_STORED(1),                                // 0xBB RestartSystem
+        JK_TOKEN_INFO_NOT_STORED(1),                                // 0xBC FactoryDataReset
+        JK_TOKEN_INFO_NOT_STORED(1),                                // 0xBD RemoteUpgradeIdentification
+        JK_TOKEN_INFO_NOT_STORED(2),                                // 0xBE GPSTurnOffVoltageMillivolt
+        JK_TOKEN_INFO_NOT_STORED(2),                                // 0xBF GPSRecoveryVoltageMillivolt
+        JK_TOKEN_INFO(1, ProtocolVersionNumber)                     // 0xC0
+        };
+static_assert(sizeof(JKReplyStruct) < JK_TOKEN_IS_NOT_STORED_OFFSET, "JKReplyStruct is too big for 8 bit offsets in JKTokenInfoArray");
 
 const char lowCapacity[] PROGMEM = "Low capacity";                          // Byte 0.0,
 const char MosFetOvertemperature[] PROGMEM = "Power MosFet overtemperature"; // Byte 0.1;
@@ -126,122 +243,353 @@ void requestJK_BMSStatusFrame(SoftwareSerialTX *aSerial, bool aDebugModeActive)
     }
 }
 
-void initJKReplyFrameBuffer() {
-    sReplyFrameBufferIndex = 0;
+/*
+ * Start receiving of a new frame by ISR
+ * Values of tokens, which are not contained in the new frame, keep the values of the last frame.
+ */
+void initJKReplyFrameReceiving() {
+    noInterrupts();
+    sReplyFrameIndex = 0;
+    sJKBMSFrameChecksum = 0;
+    sJKBMSByteWasReceived = false;
+    *sJKReceiveReplyPointer = *sJKFAllReplyPointer;
+    sJKBMSReceiveStatus = JK_BMS_RECEIVE_OK;
+    interrupts();
+}
+
+/*
+ * Must be called once after a frame was received completely, before its values are used
+ */
+void useReceivedJKReply() {
+    JKReplyStruct *tJKReply = sJKFAllReplyPointer;
+    sJKFAllReplyPointer = sJKReceiveReplyPointer;
+    sJKReceiveReplyPointer = tJKReply;
 }
 
 /*
- * Prints formatted reply buffer raw content
+ * Copy the values required for change detection
+ */
+void storeJKReplyForChangeDetection() {
+    lastJKReply.TemperaturePowerMosFet = sJKFAllReplyPointer->TemperaturePowerMosFet;
+    lastJKReply.TemperatureSensor1 = sJKFAllReplyPointer->TemperatureSensor1;
+    lastJKReply.TemperatureSensor2 = sJKFAllReplyPointer->TemperatureSensor2;
+    lastJKReply.SOCPercent = sJKFAllReplyPointer->SOCPercent;
+    lastJKReply.AlarmUnion.AlarmsAsWord = sJKFAllReplyPointer->AlarmUnion.AlarmsAsWord;
+    lastJKReply.BMSStatus.StatusAsWord = sJKFAllReplyPointer->BMSStatus.StatusAsWord;
+    lastJKReply.SystemWorkingMinutes = sJKFAllReplyPointer->SystemWorkingMinutes;
+}
+
+#define JK_BMS_RECEIVE_OK           0
+#define JK_BMS_RECEIVE_FINISHED     1
+#define JK_BMS_RECEIVE_ERROR        2
+/*
+ * The reply frame is received and decoded by ISR(USART_RX_vect) byte by byte, without storing the raw frame.
+ * This avoids the overrun of the 64 byte Arduino Serial buffer, if the loop is blocked by LCD output or beeping
+ * while the around 300 bytes of the reply frame are received.
+ * Reply starts 0.18 ms to 0.45 ms after request was received
  */
-void printJKReplyFrameBuffer() {
-    for (uint16_t i = 0; i < (sReplyFrameBufferIndex + 1); ++i) {
+volatile uint8_t sJKBMSReceiveStatus = JK_BMS_RECEIVE_FINISHED; // Bytes are only decoded if JK_BMS_RECEIVE_OK
+volatile bool sJKBMSByteWasReceived;                             // Set by ISR, reset by main loop for timeout detection
+volatile uint16_t sJKBMSFrameChecksum; // Running sum of all bytes received before the checksum, for checksum check and diagnostics
+
+/*
+ * Must be called after Serial.begin(), which does not enable the USART receive interrupt
+ */
+void enableJKReplyFrameReceiveInterrupt() {
+    uint8_t tSREG = SREG;
+    cli();
+    UCSR0B |= _BV(RXCIE0);
+    SREG = tSREG;
+}
+
+/*
+ * Rotate left and xor hash over the bytes of the static tokens, used to detect changes of the BMS configuration
+ */
+void addToStaticDataHash(uint8_t aByte) {
+    uint16_t tHash = sJKBMSStaticDataHash;
+    sJKBMSStaticDataHash = ((tHash << 1) | (tHash >> 15)) ^ aByte;
+}
+
+/*
+ * Decodes one byte of the token value pairs of the JK reply into aJKReply, using the length and offset of JKTokenInfoArray.
+ * The big endian values are stored from their end, to get the native endian format, strings are terminated with '\0'.
+ * Temperatures and current are converted to signed values after their last byte, so no consumer has to do it.
+ * sJKTokenRemainingBytes must be 0 for the first token.
+ * @return true if error happens, i.e. aByte is an undefined token. Then we do not know where the next token starts.
+ */
+bool decodeJKReplyTokenByte(uint8_t aByte, JKReplyStruct *aJKReply) {
+    uint8_t tLengthAndFlags;
+    if (sJKTokenRemainingBytes == 0) {
         /*
-         * Insert newline and address after header (11 byte), before and after cell data before trailer (9 byte) and after each 16 byte
+         * Token here
          */
-        if (i == JK_BMS_FRAME_HEADER_LENGTH || i == JK_BMS_FRAME_HEADER_LENGTH + 2
-                || i
-                        == (uint16_t) (JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH + 1
-                                + JKReplyFrameBuffer[JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH])
-                || i == ((sReplyFrameBufferIndex + 1) - JK_BMS_FRAME_TRAILER_LENGTH)
-                || (i < ((sReplyFrameBufferIndex + 1) - JK_BMS_FRAME_TRAILER_LENGTH) && i % 16 == 0) /* no 16 byte newline in trailer*/
-                ) {
-            if (i != 0) {
-                Serial.println();
-            }
-            Serial.print(F("0x"));
-            if (i < 0x10) {
-                Serial.print('0'); // padding with zero
-            }
-            Serial.print(i, HEX);
-            Serial.print(F("  "));
+        uint8_t tTokenIndex = aByte - JK_BMS_FIRST_TOKEN;
+        if (tTokenIndex > JK_BMS_LAST_TOKEN - JK_BMS_FIRST_TOKEN) {
+            return true; // token < 0x80 or > 0xC0
+        }
+        tLengthAndFlags = pgm_read_byte(&JKTokenInfoArray[tTokenIndex].LengthAndFlags);
+        uint8_t tLength = tLengthAndFlags & JK_TOKEN_LENGTH_MASK;
+        if (tLength == 0) {
+            return true; // undefined token
+        }
+        sJKToken = aByte;
+        sJKTokenLengthAndFlags = tLengthAndFlags;
+        sJKTokenRemainingBytes = tLength;
+        sJKTokenIsStatic = (aByte >= JK_BMS_FIRST_STATIC_TOKEN && aByte <= JK_BMS_LAST_STATIC_TOKEN
+                && aByte != JK_BMS_SYSTEM_WORKING_MINUTES_TOKEN);
+        if (sJKTokenIsStatic) {
+            addToStaticDataHash(aByte);
         }
 
-        Serial.print(F("0x"));
-        if (JKReplyFrameBuffer[i] < 0x10) {
-            Serial.print('0'); // padding with zero
+        uint8_t tOffset = pgm_read_byte(&JKTokenInfoArray[tTokenIndex].OffsetInReplyStruct);
+        uint8_t *tDestination = NULL;
+        if (tOffset != JK_TOKEN_IS_NOT_STORED_OFFSET) {
+            tDestination = reinterpret_cast<uint8_t*>(aJKReply) + tOffset;
+            if (tLengthAndFlags & JK_TOKEN_IS_STRING_FLAG) {
+                tDestination[tLength] = '\0';
+            } else {
+                tDestination += tLength; // big endian value is stored from end to start, to get little endian
+            }
         }
-        Serial.print(JKReplyFrameBuffer[i], HEX);
-        Serial.print(' ');
+        sJKTokenValuePointer = tDestination;
+        return false;
+    }
 
+    /*
+     * Value byte here
+     */
+    sJKTokenRemainingBytes--;
+    if (sJKTokenIsStatic) {
+        addToStaticDataHash(aByte);
     }
-    Serial.println();
+    uint8_t *tDestination = sJKTokenValuePointer;
+    if (tDestination != NULL) {
+        tLengthAndFlags = sJKTokenLengthAndFlags;
+        if (tLengthAndFlags & JK_TOKEN_IS_STRING_FLAG) {
+            *tDestination++ = aByte;
+        } else {
+            *--tDestination = aByte;
+            if (sJKTokenRemainingBytes == 0 && (tLengthAndFlags & (JK_TOKEN_IS_TEMPERATURE_FLAG | JK_TOKEN_IS_CURRENT_FLAG))) {
+                uint16_t tRawValue;
+                memcpy(&tRawValue, tDestination, 2);
+                int16_t tSignedValue;
+                if (tLengthAndFlags & JK_TOKEN_IS_TEMPERATURE_FLAG) {
+                    tSignedValue = getJKTemperature(tRawValue);
+                } else {
+                    tSignedValue = getCurrent(tRawValue);
+                }
+                memcpy(tDestination, &tSignedValue, 2);
+            }
+        }
+        sJKTokenValuePointer = tDestination;
+    }
+    return false;
 }
 
-#define JK_BMS_RECEIVE_OK           0
-#define JK_BMS_RECEIVE_FINISHED     1
-#define JK_BMS_RECEIVE_ERROR        2
 /*
- * Is assumed to be called if Serial.available() is true
- * @return JK_BMS_RECEIVE_OK, if still receiving; JK_BMS_RECEIVE_FINISHED, if complete frame was successfully read
- *          JK_BMS_RECEIVE_ERROR, if frame has errors.
- * Reply starts 0.18 ms to 0.45 ms after request was received
+ * Does the plausi check of the frame, and decodes the cell info and the tokens of the received byte.
+ * Sets sJKBMSReceiveStatus to JK_BMS_RECEIVE_FINISHED, if complete frame was read and to JK_BMS_RECEIVE_ERROR, if frame has errors.
+ * In both cases sReplyFrameIndex is left at the index of the last byte received.
+ * The checksum is computed while receiving, so the check of the complete frame is done by just one compare.
+ * Decoding of tokens stops at the first token, which could not be decoded, but the frame is not rejected.
+ * Called by ISR(USART_RX_vect) and for STANDALONE_TEST.
  */
-uint8_t readJK_BMSStatusFrameByte() {
-    uint8_t tReceivedByte = Serial.read();
-    JKReplyFrameBuffer[sReplyFrameBufferIndex] = tReceivedByte;
+void handleJKReplyFrameReceivedByte(uint8_t aReceivedByte) {
+    if (sJKBMSReceiveStatus != JK_BMS_RECEIVE_OK) {
+        return; // No frame requested or frame already complete
+    }
+    sJKBMSByteWasReceived = true;
+    sReplyFrameLastByte = aReceivedByte;
+    uint16_t tReplyFrameIndex = sReplyFrameIndex;
+    // The 4 bytes of checksum are not included, the length of frame is known from index 4 on
+    if (tReplyFrameIndex <= 3 || tReplyFrameIndex < sReplyFrameLength - 2) {
+        sJKBMSFrameChecksum += aReceivedByte;
+    }
 
     /*
      * Plausi check and get length of frame
      */
-    if (sReplyFrameBufferIndex == 0) {
+    if (tReplyFrameIndex == 0) {
         // start byte 1
-        if (tReceivedByte != JK_FRAME_START_BYTE_0) {
-            Serial.println(F("Error start frame token != 0x4E"));
-            return JK_BMS_RECEIVE_ERROR;
+        if (aReceivedByte != JK_FRAME_START_BYTE_0) {
+            sJKBMSReceiveStatus = JK_BMS_RECEIVE_ERROR;
+            return;
         }
-    } else if (sReplyFrameBufferIndex == 1) {
-        if (tReceivedByte != JK_FRAME_START_BYTE_1) {
-            // Error
-            return JK_BMS_RECEIVE_ERROR;
+    } else if (tReplyFrameIndex == 1) {
+        if (aReceivedByte != JK_FRAME_START_BYTE_1) {
+            sJKBMSReceiveStatus = JK_BMS_RECEIVE_ERROR;
+            return;
         }
 
-    } else if (sReplyFrameBufferIndex == 3) {
+    } else if (tReplyFrameIndex == 2) {
+        sReplyFrameLength = aReceivedByte << 8;
+
+    } else if (tReplyFrameIndex == 3) {
         // length of frame
-        sReplyFrameLength = (JKReplyFrameBuffer[2] << 8) + tReceivedByte;
+        sReplyFrameLength |= aReceivedByte;
+        if (sReplyFrameLength <= MINIMAL_JK_BMS_FRAME_LENGTH || sReplyFrameLength > MAXIMUM_JK_BMS_FRAME_LENGTH) {
+            sJKBMSReceiveStatus = JK_BMS_RECEIVE_ERROR;
+            return;
+        }
 
-    } else if (sReplyFrameLength > MINIMAL_JK_BMS_FRAME_LENGTH && sReplyFrameBufferIndex == sReplyFrameLength - 3) {
+    } else if (tReplyFrameIndex == sReplyFrameLength - 3) {
         // Check end token 0x68
-        if (tReceivedByte != JK_FRAME_END_BYTE) {
-            Serial.print(F("Error end frame token 0x"));
-            Serial.print(tReceivedByte, HEX);
-            Serial.print(F(" at index"));
-            Serial.print(sReplyFrameBufferIndex);
-            Serial.print(F(" is != 0x68. sReplyFrameLength= "));
-            Serial.print(sReplyFrameLength);
-            Serial.print(F(" | 0x"));
-            Serial.println(sReplyFrameLength, HEX);
-            return JK_BMS_RECEIVE_ERROR;
+        if (aReceivedByte != JK_FRAME_END_BYTE) {
+            sJKBMSReceiveStatus = JK_BMS_RECEIVE_ERROR;
+            return;
         }
 
-    } else if (sReplyFrameLength > MINIMAL_JK_BMS_FRAME_LENGTH && sReplyFrameBufferIndex == sReplyFrameLength + 1) {
+    } else if (tReplyFrameIndex == sReplyFrameLength) {
+        sReplyFrameChecksumHighByte = aReceivedByte;
+
+    } else if (tReplyFrameIndex == sReplyFrameLength + 1) {
         /*
          * Frame received completely, perform checksum check
          */
-        uint16_t tComputedChecksum = 0;
-        for (uint16_t i = 0; i < sReplyFrameLength - 2; i++) {
-            tComputedChecksum = tComputedChecksum + JKReplyFrameBuffer[i];
+        if (sJKBMSFrameChecksum == (uint16_t) ((sReplyFrameChecksumHighByte << 8) + aReceivedByte)) {
+            sJKBMSReceiveStatus = JK_BMS_RECEIVE_FINISHED;
+        } else {
+            sJKBMSReceiveStatus = JK_BMS_RECEIVE_ERROR;
+        }
+        return;
+
+    } else if (tReplyFrameIndex < JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH) {
+        ; // Rest of header and token 0x79 are not used
+
+    } else if (tReplyFrameIndex == JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH) {
+        sReplyCellInfoLength = aReceivedByte;
+        sReplyCellIndex = 0;
+        sReplyCellByteIndex = 0;
+        sReplyCellMinimumMillivolt = 0xFFFF;
+        sReplyCellMaximumMillivolt = 0;
+        sReplyCellMillivoltSum = 0;
+        sReplyNumberOfNonNullCellInfo = 0;
+        sJKTokenRemainingBytes = 0;
+        sJKBMSTokenErrorIndex = 0;
+        sJKBMSStaticDataHash = 0;
+
+    } else if (tReplyFrameIndex <= JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH + sReplyCellInfoLength) {
+        /*
+         * Cell info of 3 bytes, cell number followed by big endian cell millivolt.
+         * Cells above MAXIMUM_NUMBER_OF_CELLS are counted, but not stored.
+         */
+        uint8_t tCellIndex = sReplyCellIndex;
+        uint8_t tCellByteIndex = sReplyCellByteIndex;
+        if (tCellIndex < MAXIMUM_NUMBER_OF_CELLS) {
+            if (tCellByteIndex == 1) {
+                sReplyCellMillivoltArray[tCellIndex] = aReceivedByte << 8;
+            } else if (tCellByteIndex == 2) {
+                uint16_t tMillivolt = sReplyCellMillivoltArray[tCellIndex] | aReceivedByte;
+                sReplyCellMillivoltArray[tCellIndex] = tMillivolt;
+                if (tMillivolt > 0) {
+                    sReplyNumberOfNonNullCellInfo++;
+                    sReplyCellMillivoltSum += tMillivolt;
+                    if (sReplyCellMinimumMillivolt > tMillivolt) {
+                        sReplyCellMinimumMillivolt = tMillivolt;
+                    }
+                    if (sReplyCellMaximumMillivolt < tMillivolt) {
+                        sReplyCellMaximumMillivolt = tMillivolt;
+                    }
+                }
+            }
+        }
+        if (tCellByteIndex == 2) {
+            sReplyCellIndex = tCellIndex + 1;
+            tCellByteIndex = 0;
+        } else {
+            tCellByteIndex++;
+        }
+        sReplyCellByteIndex = tCellByteIndex;
+
+    } else if (sJKBMSTokenErrorIndex == 0) {
+        /*
+         * Token data up to the trailer
+         */
+        if (tReplyFrameIndex < sReplyFrameLength + 2 - JK_BMS_FRAME_TRAILER_LENGTH) {
+            if (decodeJKReplyTokenByte(aReceivedByte, sJKReceiveReplyPointer)) {
+                sJKBMSTokenErrorIndex = tReplyFrameIndex;
+                sJKBMSTokenErrorByte = aReceivedByte;
+            }
+        } else if (sJKTokenRemainingBytes != 0) {
+            // The value of the last token is truncated by the trailer
+            sJKBMSTokenErrorIndex = tReplyFrameIndex;
+            sJKBMSTokenErrorByte = sJKToken;
+            sJKTokenRemainingBytes = 0;
         }
-        uint16_t tReceivedChecksum = (JKReplyFrameBuffer[sReplyFrameLength] << 8) + tReceivedByte;
-        if (tComputedChecksum != tReceivedChecksum) {
+    }
+    sReplyFrameIndex = tReplyFrameIndex + 1;
+}
+
+ISR(USART_RX_vect) {
+    handleJKReplyFrameReceivedByte(UDR0); // UDR0 must be read to clear the interrupt flag
+}
+
+/*
+ * Compares the hash of the static tokens of the last received frame with the one of the last call.
+ * Prints a message if the configuration of the BMS changed.
+ * @return true if configuration changed or for the first frame
+ */
+bool checkJKStaticDataChange() {
+    if (sLastJKBMSStaticDataHashIsValid && sJKBMSStaticDataHash == sLastJKBMSStaticDataHash) {
+        return false;
+    }
+    if (sLastJKBMSStaticDataHashIsValid) {
+        Serial.print(F("BMS configuration changed, hash=0x"));
+        Serial.println(sJKBMSStaticDataHash, HEX);
+    }
+    sLastJKBMSStaticDataHash = sJKBMSStaticDataHash;
+    sLastJKBMSStaticDataHashIsValid = true;
+    return true;
+}
+
+/*
+ * Must be called by main loop, if frame was requested
+ * Prints the error detected by ISR
+ * @return JK_BMS_RECEIVE_OK, if still receiving; JK_BMS_RECEIVE_FINISHED, if complete frame was successfully read
+ *          JK_BMS_RECEIVE_ERROR, if frame has errors.
+ */
+uint8_t checkJK_BMSStatusFrame() {
+    uint8_t tReceiveStatus = sJKBMSReceiveStatus;
+    if (tReceiveStatus == JK_BMS_RECEIVE_ERROR) {
+        uint8_t tReceivedByte = sReplyFrameLastByte;
+        if (sReplyFrameIndex <= 1) {
+            Serial.print(F("Error start frame token 0x"));
+            Serial.print(tReceivedByte, HEX);
+            Serial.println(F(" is != 0x4E57"));
+        } else if (sReplyFrameIndex == 3) {
+            Serial.print(F("Error frame length="));
+            Serial.println(sReplyFrameLength);
+        } else if (sReplyFrameIndex == sReplyFrameLength + 1) {
             Serial.print(F("Checksum error, computed checksum=0x"));
-            Serial.print(tComputedChecksum, HEX);
+            Serial.print(sJKBMSFrameChecksum, HEX);
             Serial.print(F(", received checksum=0x"));
-            Serial.println(tReceivedChecksum, HEX);
-
-            return JK_BMS_RECEIVE_ERROR;
+            Serial.println((uint16_t) ((sReplyFrameChecksumHighByte << 8) + tReceivedByte), HEX);
         } else {
-            return JK_BMS_RECEIVE_FINISHED;
+            Serial.print(F("Error end frame token 0x"));
+            Serial.print(tReceivedByte, HEX);
+            Serial.print(F(" at index"));
+            Serial.print(sReplyFrameIndex);
+            Serial.print(F(" is != 0x68. sReplyFrameLength= "));
+            Serial.print(sReplyFrameLength);
+            Serial.print(F(" | 0x"));
+            Serial.println(sReplyFrameLength, HEX);
         }
+
+    } else if (tReceiveStatus == JK_BMS_RECEIVE_FINISHED && sJKBMSTokenErrorIndex != 0) {
+        Serial.print(F("Error decoding token 0x"));
+        Serial.print(sJKBMSTokenErrorByte, HEX);
+        Serial.print(F(" at index "));
+        Serial.println(sJKBMSTokenErrorIndex);
     }
-    sReplyFrameBufferIndex++;
-    return JK_BMS_RECEIVE_OK;
+    return tReceiveStatus;
 }
 
 /*
+ * Converts the native endian current value of token 0x84
  * Charge is positive, discharge is negative
  */
 int16_t getCurrent(uint16_t aJKRAWCurrent) {
-    uint16_t tCurrent = swap(aJKRAWCurrent);
+    uint16_t tCurrent = aJKRAWCurrent;
     if (tCurrent == 0 || (tCurrent & 0x8000) == 0x8000) {
         // Charge
         return (tCurrent & 0x7FFF);
@@ -251,8 +599,11 @@ int16_t getCurrent(uint16_t aJKRAWCurrent) {
 
 }
 
+/*
+ * Converts the native endian temperature values of token 0x80 to 0x82
+ */
 int16_t getJKTemperature(uint16_t aJKRAWTemperature) {
-    uint16_t tTemperature = swap(aJKRAWTemperature);
+    uint16_t tTemperature = aJKRAWTemperature;
     if (tTemperature <= 100) {
         return tTemperature;
     }
@@ -303,25 +654,45 @@ void myPrint(const __FlashStringHelper *aPGMString, int16_t a16BitValue) {
     Serial.print(a16BitValue);
 }
 
-void myPrintlnSwap(const __FlashStringHelper *aPGMString, uint16_t a16BitValue) {
-    Serial.print(aPGMString);
-    Serial.println(swap(a16BitValue));
-}
-
-void myPrintlnSwap(const __FlashStringHelper *aPGMString, int16_t a16BitValue) {
+void myPrint(const __FlashStringHelper *aPGMString, uint32_t a32BitValue) {
     Serial.print(aPGMString);
-    Serial.println((int16_t) swap((uint16_t) a16BitValue));
+    Serial.print(a32BitValue);
 }
 
-void myPrintSwap(const __FlashStringHelper *aPGMString, int16_t a16BitValue) {
+void myPrintln(const __FlashStringHelper *aPGMString, uint32_t a32BitValue) {
     Serial.print(aPGMString);
-    Serial.print((int16_t) swap((uint16_t) a16BitValue));
+    Serial.println(a32BitValue);
 }
 
-void myPrintlnSwap(const __FlashStringHelper *aPGMString, uint32_t a32BitValue) {
-    Serial.print(aPGMString);
-    Serial.println(swap(a32BitValue));
+#if defined(USE_FIXED_POINT)
+/*
+ * Prints a value in units of 10 mV or 10 mA as volt or ampere with 0 to 2 decimal places,
+ * rounded like Print::print(float, aNumberOfDecimalPlaces) does, but without the soft-float library.
+ */
+void printHundredths(Print *aPrint, int32_t aValueInHundredths, uint8_t aNumberOfDecimalPlaces) {
+    if (aValueInHundredths < 0) {
+        aPrint->print('-');
+        aValueInHundredths = -aValueInHundredths;
+    }
+    uint8_t tDivisor = 1;
+    if (aNumberOfDecimalPlaces == 0) {
+        tDivisor = 100;
+    } else if (aNumberOfDecimalPlaces == 1) {
+        tDivisor = 10;
+    }
+    aValueInHundredths = (aValueInHundredths + (tDivisor / 2)) / tDivisor;
+    uint8_t tScale = 100 / tDivisor; // 1, 10 or 100
+    aPrint->print(aValueInHundredths / tScale);
+    if (aNumberOfDecimalPlaces > 0) {
+        aPrint->print('.');
+        uint8_t tFraction = aValueInHundredths % tScale;
+        if (aNumberOfDecimalPlaces > 1 && tFraction < 10) {
+            aPrint->print('0');
+        }
+        aPrint->print(tFraction);
+    }
 }
+#endif
 
 /*
  * Due to wrong SOC calculation of JKBMS that caused inverter to work incorrectly, I make this mapping of SOC based on voltage
@@ -335,19 +706,23 @@ uint16_t getMappedSOC(uint16_t AverageRefVoltage){
   uint8_t fakeSoc;
   uint8_t arrLength;    
 
-  if (JKComputedData.BatteryType == 0) {
+  if (sJKFAllReplyPointer->BatteryType == 0) {
     //Serial.println(F("<<<LFP battery>>>"));
     arrLength=LFP_LEN;
     pMapVol = MapVoltLFP;
     pMapSOC = MapSOCLFP;
     
-  }else if (JKComputedData.BatteryType == 1) {
+  }else if (sJKFAllReplyPointer->BatteryType == 1) {
     //Serial.println(F("<<<Lion battery>>>"));
     arrLength=LION_LEN;
     pMapVol = MapVoltLion;
     pMapSOC = MapSOCLion;    
   }
+#if defined(USE_FIXED_POINT)
+  if (JKComputedData.BatteryLoadCurrent10Milliampere > 0){
+#else
   if (JKComputedData.BatteryLoadCurrentFloat > 0){
+#endif
     // While charging, charged voltage is about greater than opened circuit, minimum voltage should be referred, even the difference is not much
     RefVoltage = AverageRefVoltage;//MinRefVoltage;
   }else{
@@ -358,7 +733,7 @@ uint16_t getMappedSOC(uint16_t AverageRefVoltage){
       fakeSoc = map(RefVoltage, *(pMapVol + ptr), *(pMapVol + ptr + 1), *(pMapSOC +ptr), *(pMapSOC + ptr + 1));
       /*
       Serial.println(F("Battery Type:"));
-      Serial.print(JKComputedData.BatteryType,HEX);
+      Serial.print(sJKFAllReplyPointer->BatteryType,HEX);
       Serial.println(F("Voltage"));
       Serial.print(AverageRefVoltage);
       Serial.print(F("/"));
@@ -376,15 +751,44 @@ uint16_t getMappedSOC(uint16_t AverageRefVoltage){
   return 20;
 }
 
+uint32_t sMillisOfLastStatisticsReply;
+
 /*
- * Convert the big endian cell voltage data from JKReplyFrameBuffer to little endian data in JKConvertedCellInfo
- * and compute minimum, maximum, delta, and average
+ * Must be called once for each reply. millis() is adjusted by sleepWithWatchdog(), so sleeping between the replies is counted.
+ * @return the milliseconds since the last reply or 0 if the gap was longer than MAXIMUM_MILLISECONDS_FOR_STATISTICS,
+ *         because we do not know what happened during this time
  */
-void fillJKConvertedCellInfo() {
-//    uint8_t *tJKCellInfoReplyPointer = &TestJKReplyStatusFrame[11];
-    uint8_t *tJKCellInfoReplyPointer = &JKReplyFrameBuffer[JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH];
+uint16_t getStatisticsMillisSinceLastReply() {
+    uint32_t tMillis = millis();
+    uint32_t tElapsedMillis = tMillis - sMillisOfLastStatisticsReply;
+    sMillisOfLastStatisticsReply = tMillis;
+    if (tElapsedMillis > MAXIMUM_MILLISECONDS_FOR_STATISTICS) {
+        return 0;
+    }
+    return tElapsedMillis;
+}
 
-    uint8_t tNumberOfCellInfo = (*tJKCellInfoReplyPointer++) / 3;
+/*
+ * Accumulates aMillis to the units of aStatisticsTime, the remainder is kept for the next call
+ * @return number of units added
+ */
+uint16_t addStatisticsMillis(struct StatisticsTimeStruct *aStatisticsTime, uint16_t aMillis, uint16_t aMillisPerUnit) {
+    uint32_t tMillis = (uint32_t) aStatisticsTime->RemainderMillis + aMillis;
+    uint16_t tUnits = tMillis / aMillisPerUnit;
+    aStatisticsTime->RemainderMillis = tMillis - ((uint32_t) tUnits * aMillisPerUnit);
+    aStatisticsTime->Units += tUnits;
+    return tUnits;
+}
+
+/*
+ * Copy the cell voltage data converted by the receive ISR to JKConvertedCellInfo,
+ * mark and count minimum and maximum cell voltages in one pass.
+ * Minimum, maximum and sum of cell voltages were already computed by the ISR.
+ * The counts and the balancing time are time based, see getStatisticsMillisSinceLastReply().
+ */
+void fillJKConvertedCellInfo() {
+    uint16_t tStatisticsMillis = getStatisticsMillisSinceLastReply();
+    uint8_t tNumberOfCellInfo = sReplyCellInfoLength / 3;
     JKConvertedCellInfo.ActualNumberOfCellInfoEntries = tNumberOfCellInfo;
     if (tNumberOfCellInfo > MAXIMUM_NUMBER_OF_CELLS) {
         Serial.print(F("Error: Program compiled with \"MAXIMUM_NUMBER_OF_CELLS=" STR(MAXIMUM_NUMBER_OF_CELLS) "\", but "));
@@ -393,46 +797,47 @@ void fillJKConvertedCellInfo() {
         return;
     }
 
-    uint16_t tVoltage;
-    uint32_t tMillivoltSum = 0;
-    uint8_t tNumberOfNonNullCellInfo = 0;
-    uint16_t tMinimumMillivolt = 0xFFFF;
-    uint16_t tMaximumMillivolt = 0;
-
-    for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
-        tJKCellInfoReplyPointer++;                                  // Skip Cell number
-        uint8_t tHighByte = *tJKCellInfoReplyPointer++;             // Copy CellMillivolt
-        tVoltage = tHighByte << 8 | *tJKCellInfoReplyPointer++;
-        JKConvertedCellInfo.CellInfoStructArray[i].CellMillivolt = tVoltage;
-        if (tVoltage > 0) {
-            tNumberOfNonNullCellInfo++;
-            tMillivoltSum += tVoltage;
-            if (tMinimumMillivolt > tVoltage) {
-                tMinimumMillivolt = tVoltage;
-            }
-            if (tMaximumMillivolt < tVoltage) {
-                tMaximumMillivolt = tVoltage;
-            }
-        }
-    }
+    uint8_t tNumberOfNonNullCellInfo = sReplyNumberOfNonNullCellInfo;
+    uint16_t tMinimumMillivolt = sReplyCellMinimumMillivolt;
+    uint16_t tMaximumMillivolt = sReplyCellMaximumMillivolt;
     JKConvertedCellInfo.MinimumCellMillivolt = tMinimumMillivolt;
     JKConvertedCellInfo.MaximumCellMillivolt = tMaximumMillivolt;
     JKConvertedCellInfo.DeltaCellMillivolt = tMaximumMillivolt - tMinimumMillivolt;
-    JKConvertedCellInfo.AverageCellMillivolt = tMillivoltSum / tNumberOfNonNullCellInfo;
-
-    /*
-     * Mark and count minimum and maximum cell voltages
-     */
+    JKConvertedCellInfo.AverageCellMillivolt = sReplyCellMillivoltSum / tNumberOfNonNullCellInfo;
+
+    bool tBalancerActive = sJKFAllReplyPointer->BMSStatus.StatusBits.BalancerActive;
+    uint16_t tStatisticsCounts = 0;
+    if (tBalancerActive) {
+        tStatisticsCounts = addStatisticsMillis(&sCellStatisticsTime, tStatisticsMillis, MILLISECONDS_PER_CELL_STATISTICS_COUNT);
+        addStatisticsMillis(&sBalancingTime, tStatisticsMillis, 1000);
+        uint32_t tBalancingMinutes = sBalancingTime.Units / 60;
+        sprintf_P(sBalancingTimeString, PSTR("%3uD%02uH%02uM"), (uint16_t) (tBalancingMinutes / (60 * 24)),
+                (uint16_t) ((tBalancingMinutes / 60) % 24), (uint16_t) (tBalancingMinutes % 60));
+    }
+    bool tDoDaylyMinimumScaling = false;
+    bool tDoDaylyMaximumScaling = false;
     for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
-        if (JKConvertedCellInfo.CellInfoStructArray[i].CellMillivolt == tMinimumMillivolt) {
+        uint16_t tVoltage = sReplyCellMillivoltArray[i];
+        JKConvertedCellInfo.CellInfoStructArray[i].CellMillivolt = tVoltage;
+        /*
+         * Mark and count minimum and maximum cell voltages.
+         * After CELL_STATISTICS_COUNT_FOR_SCALING counts (a whole day being the minimum / maximum) we do scaling
+         */
+        if (tVoltage == tMinimumMillivolt) {
             JKConvertedCellInfo.CellInfoStructArray[i].VoltageIsMinMaxOrBetween = VOLTAGE_IS_MINIMUM;
-            if (sJKFAllReplyPointer->BMSStatus.StatusBits.BalancerActive) {
-                CellMinimumArray[i]++; // count for statistics
+            if (tBalancerActive) {
+                CellMinimumArray[i] += tStatisticsCounts;
+                if (CellMinimumArray[i] > CELL_STATISTICS_COUNT_FOR_SCALING) {
+                    tDoDaylyMinimumScaling = true;
+                }
             }
-        } else if (JKConvertedCellInfo.CellInfoStructArray[i].CellMillivolt == tMaximumMillivolt) {
+        } else if (tVoltage == tMaximumMillivolt) {
             JKConvertedCellInfo.CellInfoStructArray[i].VoltageIsMinMaxOrBetween = VOLTAGE_IS_MAXIMUM;
-            if (sJKFAllReplyPointer->BMSStatus.StatusBits.BalancerActive) {
-                CellMaximumArray[i]++;
+            if (tBalancerActive) {
+                CellMaximumArray[i] += tStatisticsCounts;
+                if (CellMaximumArray[i] > CELL_STATISTICS_COUNT_FOR_SCALING) {
+                    tDoDaylyMaximumScaling = true;
+                }
             }
         } else {
             JKConvertedCellInfo.CellInfoStructArray[i].VoltageIsMinMaxOrBetween = VOLTAGE_IS_BETWEEN_MINIMUM_AND_MAXIMUM;
@@ -440,70 +845,15 @@ void fillJKConvertedCellInfo() {
     }
 
     /*
-     * Process minimum statistics
+     * Do scaling by dividing all values by 2 resulting in an Exponential Moving Average filter for values
      */
-    uint32_t tCellStatisticsSum = 0;
-    bool tDoDaylyScaling = false;
-    for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
-        /*
-         * After 43200 counts (a whole day being the minimum / maximum) we do scaling
-         */
-        uint16_t tCellStatisticsCount = CellMinimumArray[i];
-        tCellStatisticsSum += tCellStatisticsCount;
-        if (tCellStatisticsCount > (60UL * 60UL * 24UL * 1000UL / MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS)) {
-            /*
-             * After 43200 counts (a whole day being the minimum / maximum) we do scaling
-             */
-            tDoDaylyScaling = true;
-        }
-    }
-
-    // Here, we demand 2 minutes of balancing as minimum
-    if (tCellStatisticsSum > 60) {
-        for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
-            CellMinimumPercentageArray[i] = ((uint32_t) (CellMinimumArray[i] * 100UL)) / tCellStatisticsSum;
-        }
-    }
-
-    if (tDoDaylyScaling) {
-        /*
-         * Do scaling by dividing all values by 2 resulting in an Exponential Moving Average filter for values
-         */
+    if (tDoDaylyMinimumScaling) {
         Serial.println(F("Do scaling of minimum counts"));
         for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
             CellMinimumArray[i] = CellMinimumArray[i] / 2;
         }
     }
-
-    /*
-     * Process maximum statistics
-     */
-    tCellStatisticsSum = 0;
-    tDoDaylyScaling = false;
-    for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
-        /*
-         * After 43200 counts (a whole day being the minimum / maximum) we do scaling
-         */
-        uint16_t tCellStatisticsCount = CellMaximumArray[i];
-        tCellStatisticsSum += tCellStatisticsCount;
-        if (tCellStatisticsCount > (60UL * 60UL * 24UL * 1000UL / MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS)) {
-            /*
-             * After 43200 counts (a whole day being the minimum / maximum) we do scaling
-             */
-            tDoDaylyScaling = true;
-        }
-    }
-
-    // Here, we demand 2 minutes of balancing as minimum
-    if (tCellStatisticsSum > 60) {
-        for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
-            CellMaximumPercentageArray[i] = ((uint32_t) (CellMaximumArray[i] * 100UL)) / tCellStatisticsSum;
-        }
-    }
-    if (tDoDaylyScaling) {
-        /*
-         * Do scaling by dividing all values by 2 resulting in an Exponential Moving Average filter for values
-         */
+    if (tDoDaylyMaximumScaling) {
         Serial.println(F("Do scaling of maximum counts"));
         for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
             CellMaximumArray[i] = CellMaximumArray[i] / 2;
@@ -525,63 +875,70 @@ void fillJKConvertedCellInfo() {
 }
 
 void fillJKComputedData() {
-    JKComputedData.TemperaturePowerMosFet = getJKTemperature(sJKFAllReplyPointer->TemperaturePowerMosFet);
-    int16_t tMaxTemperature = JKComputedData.TemperaturePowerMosFet;
-
-    JKComputedData.TemperatureSensor1 = getJKTemperature(sJKFAllReplyPointer->TemperatureSensor1);
-    if (tMaxTemperature < JKComputedData.TemperatureSensor1) {
-        tMaxTemperature = JKComputedData.TemperatureSensor1;
+    int16_t tMaxTemperature = sJKFAllReplyPointer->TemperaturePowerMosFet;
+    if (tMaxTemperature < sJKFAllReplyPointer->TemperatureSensor1) {
+        tMaxTemperature = sJKFAllReplyPointer->TemperatureSensor1;
     }
-
-    JKComputedData.TemperatureSensor2 = getJKTemperature(sJKFAllReplyPointer->TemperatureSensor2);
-    if (tMaxTemperature < JKComputedData.TemperatureSensor2) {
-        tMaxTemperature = JKComputedData.TemperatureSensor2;
+    if (tMaxTemperature < sJKFAllReplyPointer->TemperatureSensor2) {
+        tMaxTemperature = sJKFAllReplyPointer->TemperatureSensor2;
     }
     JKComputedData.TemperatureMaximum = tMaxTemperature;
 
-    JKComputedData.TotalCapacityAmpereHour = swap(sJKFAllReplyPointer->TotalCapacityAmpereHour);
     // 16 bit multiplication gives overflow at 640 Ah
-    JKComputedData.RemainingCapacityAmpereHour = ((uint32_t) JKComputedData.TotalCapacityAmpereHour
-            * sJKFAllReplyPointer->SOCPercent) / 100;
+    JKComputedData.RemainingCapacityAmpereHour = (sJKFAllReplyPointer->TotalCapacityAmpereHour * sJKFAllReplyPointer->SOCPercent) / 100;
 
     // Two values which are zero during JK-BMS startup for around 16 seconds
     JKComputedData.BMSIsStarting = (sJKFAllReplyPointer->SOCPercent == 0 && sJKFAllReplyPointer->Cycles == 0);
 
-    JKComputedData.BatteryFullVoltage10Millivolt = swap(sJKFAllReplyPointer->BatteryOvervoltageProtection10Millivolt);
-    JKComputedData.BatteryVoltage10Millivolt = swap(sJKFAllReplyPointer->Battery10Millivolt);
-    JKComputedData.BatteryVoltageFloat = JKComputedData.BatteryVoltage10Millivolt;
+#if defined(USE_FIXED_POINT)
+    JKComputedData.BatteryVoltage10Millivolt = sJKFAllReplyPointer->Battery10Millivolt;
+    JKComputedData.BatteryLoadCurrent10Milliampere = sJKFAllReplyPointer->Battery10MilliAmpere;
+    // 10 mV * 10 mA = 100 uW, truncated towards zero like the float to int16_t conversion
+    JKComputedData.BatteryLoadPower = ((int32_t) JKComputedData.BatteryVoltage10Millivolt
+            * JKComputedData.BatteryLoadCurrent10Milliampere) / 10000;
+#else
+    JKComputedData.BatteryVoltageFloat = sJKFAllReplyPointer->Battery10Millivolt;
     JKComputedData.BatteryVoltageFloat /= 100;
 
-    JKComputedData.Battery10MilliAmpere = getCurrent(sJKFAllReplyPointer->Battery10MilliAmpere);
-    JKComputedData.BatteryLoadCurrentFloat = JKComputedData.Battery10MilliAmpere;
+    JKComputedData.BatteryLoadCurrentFloat = sJKFAllReplyPointer->Battery10MilliAmpere;
     JKComputedData.BatteryLoadCurrentFloat /= 100;
 
-//    Serial.print("Battery10MilliAmpere=0x");
-//    Serial.print(sJKFAllReplyPointer->Battery10MilliAmpere, HEX);
-//    Serial.print(" Battery10MilliAmpere swapped=0x");
-//    Serial.println(swap(sJKFAllReplyPointer->Battery10MilliAmpere), HEX);
 //    Serial.print(" Battery10MilliAmpere=");
-//    Serial.print(JKComputedData.Battery10MilliAmpere);
+//    Serial.print(sJKFAllReplyPointer->Battery10MilliAmpere);
 //    Serial.print(" BatteryLoadCurrent=");
 //    Serial.println(JKComputedData.BatteryLoadCurrentFloat);
 
     JKComputedData.BatteryLoadPower = JKComputedData.BatteryVoltageFloat * JKComputedData.BatteryLoadCurrentFloat;
+#endif
 
 // added by Ngoc for sending cell max/min volt to Luxpower
-    JKComputedData.BatteryType = sJKFAllReplyPointer->BatteryType; 
     JKComputedData.MinimumCellMillivolt = JKConvertedCellInfo.MinimumCellMillivolt;
     JKComputedData.MaximumCellMillivolt = JKConvertedCellInfo.MaximumCellMillivolt;
 // For calculating Fake SOC
     JKComputedData.AverageCellMillivolt = JKConvertedCellInfo.AverageCellMillivolt;
     JKComputedData.ActualNumberOfCellInfoEntries = JKConvertedCellInfo.ActualNumberOfCellInfoEntries;
     JKComputedData.SOCPercent = getMappedSOC(JKConvertedCellInfo.AverageCellMillivolt);
-        
+}
 
-    if (sJKFAllReplyPointer->BMSStatus.StatusBits.BalancerActive) {
-        sBalancingCount++;
-        sprintf_P(sBalancingTimeString, PSTR("%3uD%02uH%02uM"), (uint16_t) (sBalancingCount / (60 * 24 * 30UL)),
-                (uint16_t) ((sBalancingCount / (60 * 30)) % 24), (uint16_t) (sBalancingCount / 30) % 60);
+/*
+ * @return sum of the counts of all cells of CellMinimumArray or CellMaximumArray
+ */
+uint32_t getCellStatisticsSum(uint16_t *aCellStatisticsArray) {
+    uint32_t tCellStatisticsSum = 0;
+    for (uint8_t i = 0; i < JKConvertedCellInfo.ActualNumberOfCellInfoEntries; ++i) {
+        tCellStatisticsSum += aCellStatisticsArray[i];
     }
+    return tCellStatisticsSum;
+}
+
+/*
+ * @return 0 if sum is too small for a meaningful percentage
+ */
+uint8_t getCellStatisticsPercentage(uint16_t aCellStatisticsCount, uint32_t aCellStatisticsSum) {
+    if (aCellStatisticsSum <= MINIMUM_CELL_STATISTICS_SUM_FOR_PERCENTAGE) {
+        return 0;
+    }
+    return (aCellStatisticsCount * 100UL) / aCellStatisticsSum;
 }
 
 /*
@@ -596,21 +953,25 @@ void printJKCellStatisticsInfo() {
     char tStringBuffer[18]; // "12=12 % |  4042, "
 
     Serial.println(F("Cell Minimum percentages"));
+    uint32_t tCellStatisticsSum = getCellStatisticsSum(CellMinimumArray);
     for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
         if (i != 0 && (i % 8) == 0) {
             Serial.println();
         }
-        sprintf_P(tStringBuffer, PSTR("%2u=%2u %% |%5u, "), i + 1, CellMinimumPercentageArray[i], CellMinimumArray[i]);
+        sprintf_P(tStringBuffer, PSTR("%2u=%2u %% |%5u, "), i + 1,
+                getCellStatisticsPercentage(CellMinimumArray[i], tCellStatisticsSum), CellMinimumArray[i]);
         Serial.print(tStringBuffer);
     }
     Serial.println();
 
     Serial.println(F("Cell Maximum percentages"));
+    tCellStatisticsSum = getCellStatisticsSum(CellMaximumArray);
     for (uint8_t i = 0; i < tNumberOfCellInfo; ++i) {
         if (i != 0 && (i % 8) == 0) {
             Serial.println();
         }
-        sprintf_P(tStringBuffer, PSTR("%2u=%2u %% |%5u, "), i + 1, CellMaximumPercentageArray[i], CellMaximumArray[i]);
+        sprintf_P(tStringBuffer, PSTR("%2u=%2u %% |%5u, "), i + 1,
+                getCellStatisticsPercentage(CellMaximumArray[i], tCellStatisticsSum), CellMaximumArray[i]);
         Serial.print(tStringBuffer);
     }
     Serial.println();
@@ -662,19 +1023,19 @@ void printVoltageProtectionInfo() {
     /*
      * Voltage protection
      */
-    myPrint(F("Battery Overvoltage Protection[mV]="), JKComputedData.BatteryFullVoltage10Millivolt * 10);
-    myPrintln(F(", Undervoltage="), swap(tJKFAllReply->BatteryUndervoltageProtection10Millivolt) * 10);
-    myPrintSwap(F("Cell Overvoltage Protection[mV]="), tJKFAllReply->CellOvervoltageProtectionMillivolt);
-    myPrintSwap(F(", Recovery="), tJKFAllReply->CellOvervoltageRecoveryMillivolt);
-    myPrintlnSwap(F(", Delay[s]="), tJKFAllReply->CellOvervoltageDelaySeconds);
-    myPrintSwap(F("Cell Undervoltage Protection[mV]="), tJKFAllReply->CellUndervoltageProtectionMillivolt);
-    myPrintSwap(F(", Recovery="), tJKFAllReply->CellUndervoltageRecoveryMillivolt);
-    myPrintlnSwap(F(", Delay[s]="), tJKFAllReply->CellUndervoltageDelaySeconds);
-    myPrintlnSwap(F("Cell Voltage Difference Protection[mV]="), tJKFAllReply->VoltageDifferenceProtectionMillivolt);
-    myPrintSwap(F("Discharging Overcurrent Protection[A]="), tJKFAllReply->DischargeOvercurrentProtectionAmpere);
-    myPrintlnSwap(F(", Delay[s]="), tJKFAllReply->DischargeOvercurrentDelaySeconds);
-    myPrintSwap(F("Charging Overcurrent Protection[A]="), tJKFAllReply->ChargeOvercurrentProtectionAmpere);
-    myPrintlnSwap(F(", Delay[s]="), tJKFAllReply->ChargeOvercurrentDelaySeconds);
+    myPrint(F("Battery Overvoltage Protection[mV]="), (uint16_t) (sJKFAllReplyPointer->BatteryOvervoltageProtection10Millivolt * 10));
+    myPrintln(F(", Undervoltage="), (uint16_t) (tJKFAllReply->BatteryUndervoltageProtection10Millivolt * 10));
+    myPrint(F("Cell Overvoltage Protection[mV]="), tJKFAllReply->CellOvervoltageProtectionMillivolt);
+    myPrint(F(", Recovery="), tJKFAllReply->CellOvervoltageRecoveryMillivolt);
+    myPrintln(F(", Delay[s]="), tJKFAllReply->CellOvervoltageDelaySeconds);
+    myPrint(F("Cell Undervoltage Protection[mV]="), tJKFAllReply->CellUndervoltageProtectionMillivolt);
+    myPrint(F(", Recovery="), tJKFAllReply->CellUndervoltageRecoveryMillivolt);
+    myPrintln(F(", Delay[s]="), tJKFAllReply->CellUndervoltageDelaySeconds);
+    myPrintln(F("Cell Voltage Difference Protection[mV]="), tJKFAllReply->VoltageDifferenceProtectionMillivolt);
+    myPrint(F("Discharging Overcurrent Protection[A]="), tJKFAllReply->DischargeOvercurrentProtectionAmpere);
+    myPrintln(F(", Delay[s]="), tJKFAllReply->DischargeOvercurrentDelaySeconds);
+    myPrint(F("Charging Overcurrent Protection[A]="), tJKFAllReply->ChargeOvercurrentProtectionAmpere);
+    myPrintln(F(", Delay[s]="), tJKFAllReply->ChargeOvercurrentDelaySeconds);
     Serial.println();
 }
 
@@ -683,17 +1044,17 @@ void printTemperatureProtectionInfo() {
     /*
      * Temperature protection
      */
-    myPrintSwap(F("Power MosFet Temperature Protection="), tJKFAllReply->PowerMosFetTemperatureProtection);
-    myPrintlnSwap(F(", Recovery="), tJKFAllReply->PowerMosFetRecoveryTemperature);
-    myPrintSwap(F("Sensor1 Temperature Protection="), tJKFAllReply->Sensor1TemperatureProtection);
-    myPrintlnSwap(F(", Recovery="), tJKFAllReply->Sensor1RecoveryTemperature);
-    myPrintlnSwap(F("Sensor1 to Sensor2 Temperature Difference Protection="), tJKFAllReply->BatteryDifferenceTemperatureProtection);
-    myPrintSwap(F("Charge Overtemperature Protection="), tJKFAllReply->ChargeOvertemperatureProtection);
-    myPrintlnSwap(F(", Discharge="), tJKFAllReply->DischargeOvertemperatureProtection);
-    myPrintSwap(F("Charge Undertemperature Protection="), tJKFAllReply->ChargeUndertemperatureProtection);
-    myPrintlnSwap(F(", Recovery="), tJKFAllReply->ChargeRecoveryUndertemperature);
-    myPrintSwap(F("Discharge Undertemperature Protection="), tJKFAllReply->DischargeUndertemperatureProtection);
-    myPrintlnSwap(F(", Recovery="), tJKFAllReply->DischargeRecoveryUndertemperature);
+    myPrint(F("Power MosFet Temperature Protection="), tJKFAllReply->PowerMosFetTemperatureProtection);
+    myPrintln(F(", Recovery="), tJKFAllReply->PowerMosFetRecoveryTemperature);
+    myPrint(F("Sensor1 Temperature Protection="), tJKFAllReply->Sensor1TemperatureProtection);
+    myPrintln(F(", Recovery="), tJKFAllReply->Sensor1RecoveryTemperature);
+    myPrintln(F("Sensor1 to Sensor2 Temperature Difference Protection="), tJKFAllReply->BatteryDifferenceTemperatureProtection);
+    myPrint(F("Charge Overtemperature Protection="), tJKFAllReply->ChargeOvertemperatureProtection);
+    myPrintln(F(", Discharge="), tJKFAllReply->DischargeOvertemperatureProtection);
+    myPrint(F("Charge Undertemperature Protection="), tJKFAllReply->ChargeUndertemperatureProtection);
+    myPrintln(F(", Recovery="), tJKFAllReply->ChargeRecoveryUndertemperature);
+    myPrint(F("Discharge Undertemperature Protection="), tJKFAllReply->DischargeUndertemperatureProtection);
+    myPrintln(F(", Recovery="), tJKFAllReply->DischargeRecoveryUndertemperature);
     Serial.println();
 }
 
@@ -701,22 +1062,19 @@ void printBatteryInfo() {
     JKReplyStruct *tJKFAllReply = sJKFAllReplyPointer;
 
     Serial.print(F("Manufacturer Date="));
-    tJKFAllReply->TokenSystemWorkingMinutes = '\0'; // Set end of string token
     Serial.println(tJKFAllReply->ManufacturerDate);
 
     Serial.print(F("Manufacturer Id="));   // First 8 characters of the manufacturer id entered in the app field "User Private Data"
-    tJKFAllReply->TokenProtocolVersionNumber = '\0'; // Set end of string token
     Serial.println(tJKFAllReply->ManufacturerId);
     Serial.print(F("Device ID String="));           // First 8 characters of ManufacturerId
-    tJKFAllReply->TokenManufacturerDate = '\0';     // Set end of string token
     Serial.println(tJKFAllReply->DeviceIdString);
 
     myPrintln(F("Device Address="), tJKFAllReply->BoardAddress);
-    myPrint(F("Total Battery Capacity[Ah]="), JKComputedData.TotalCapacityAmpereHour); // 0xAA
+    myPrint(F("Total Battery Capacity[Ah]="), sJKFAllReplyPointer->TotalCapacityAmpereHour); // 0xAA
     myPrintln(F(", Low Capacity Alarm Percent="), tJKFAllReply->LowCapacityAlarmPercent); // 0xB1
-    myPrintlnSwap(F("Charging Cycles="), tJKFAllReply->Cycles);
-    myPrintlnSwap(F("Total Charging Cycle Capacity="), tJKFAllReply->TotalBatteryCycleCapacity);
-    myPrintSwap(F("# Battery Cells="), tJKFAllReply->NumberOfBatteryCells); // 0x8A Total number of battery strings
+    myPrintln(F("Charging Cycles="), tJKFAllReply->Cycles);
+    myPrintln(F("Total Charging Cycle Capacity="), tJKFAllReply->TotalBatteryCycleCapacity);
+    myPrint(F("# Battery Cells="), tJKFAllReply->NumberOfBatteryCells); // 0x8A Total number of battery strings
     myPrintln(F(", Cell Count="), tJKFAllReply->BatteryCellCount); // 0xA9 Battery string count settings
     Serial.println();
 }
@@ -726,10 +1084,8 @@ void printBMSInfo() {
 
     myPrintln(F("Protocol Version Number="), tJKFAllReply->ProtocolVersionNumber);
     Serial.print(F("Software Version Number="));
-    tJKFAllReply->TokenStartCurrentCalibration = '\0'; // set end of string token
     Serial.println(tJKFAllReply->SoftwareVersionNumber);
     Serial.print(F("Modify Parameter Password="));
-    tJKFAllReply->TokenDedicatedChargerSwitchState = '\0'; // set end of string token
     Serial.println(tJKFAllReply->ModifyParameterPassword);
 
     myPrintln(F("# External Temperature Sensors="), tJKFAllReply->NumberOfTemperatureSensors); // 0x86
@@ -740,15 +1096,15 @@ void printBMSInfo() {
 void printMiscellaneousInfo() {
     JKReplyStruct *tJKFAllReply = sJKFAllReplyPointer;
 
-    myPrintlnSwap(F("Balance Starting Cell Voltage=[mV]"), tJKFAllReply->BalancingStartMillivolt);
-    myPrintlnSwap(F("Balance Triggering Voltage Difference[mV]="), tJKFAllReply->BalancingStartDifferentialMillivolt);
+    myPrintln(F("Balance Starting Cell Voltage=[mV]"), tJKFAllReply->BalancingStartMillivolt);
+    myPrintln(F("Balance Triggering Voltage Difference[mV]="), tJKFAllReply->BalancingStartDifferentialMillivolt);
     Serial.println();
-    myPrintlnSwap(F("Current Calibration[mA]="), tJKFAllReply->CurrentCalibrationMilliampere);
-    myPrintlnSwap(F("Sleep Wait Time[s]="), tJKFAllReply->SleepWaitingTimeSeconds);
+    myPrintln(F("Current Calibration[mA]="), tJKFAllReply->CurrentCalibrationMilliampere);
+    myPrintln(F("Sleep Wait Time[s]="), tJKFAllReply->SleepWaitingTimeSeconds);
     Serial.println();
     myPrintln(F("Dedicated Charge Switch Active="), tJKFAllReply->DedicatedChargerSwitchIsActive);
     myPrintln(F("Start Current Calibration State="), tJKFAllReply->StartCurrentCalibration);
-    myPrintlnSwap(F("Battery Actual Capacity[Ah]="), tJKFAllReply->ActualBatteryCapacityAmpereHour);
+    myPrintln(F("Battery Actual Capacity[Ah]="), tJKFAllReply->ActualBatteryCapacityAmpereHour);
     Serial.println();
 }
 
@@ -774,7 +1130,7 @@ void handleAndPrintAlarmInfo() {
             sErrorStatusIsError = false;
             Serial.println(F("All alarms are cleared"));
         } else {
-            uint16_t tAlarms = swap(tJKFAllReply->AlarmUnion.AlarmsAsWord);
+            uint16_t tAlarms = tJKFAllReply->AlarmUnion.AlarmsAsWord;
             Serial.println(F("*** ALARM FLAGS ***"));
             Serial.print(F("Alarm bits=0x"));
             Serial.print(tAlarms, HEX);
@@ -835,7 +1191,7 @@ void computeUpTimeString() {
     if (sJKFAllReplyPointer->SystemWorkingMinutes != lastJKReply.SystemWorkingMinutes) {
         sUpTimeStringMinuteHasChanged = true;
 
-        uint32_t tSystemWorkingMinutes = swap(sJKFAllReplyPointer->SystemWorkingMinutes);
+        uint32_t tSystemWorkingMinutes = sJKFAllReplyPointer->SystemWorkingMinutes;
 // 1 kByte for sprintf  creates string "1234D23H12M"
         sprintf_P(sUpTimeString, PSTR("%4uD%02uH%02uM"), (uint16_t) (tSystemWorkingMinutes / (60 * 24)),
                 (uint16_t) ((tSystemWorkingMinutes / 60) % 24), (uint16_t) tSystemWorkingMinutes % 60);
@@ -849,7 +1205,7 @@ void computeUpTimeString() {
 /*
  * Print received data
  * Use converted cell voltage info from JKConvertedCellInfo
- * All other data are used unconverted and are therefore printed by swap() functions.
+ * All other data are printed from the decoded sJKFAllReplyPointer->
  */
 void printJKDynamicInfo() {
     JKReplyStruct *tJKFAllReply = sJKFAllReplyPointer;
@@ -863,39 +1219,39 @@ void printJKDynamicInfo() {
         sUpTimeStringTenthOfMinuteHasChanged = false;
 
         Serial.print(F("Total Runtime Minutes="));
-        Serial.print(swap(sJKFAllReplyPointer->SystemWorkingMinutes));
+        Serial.print(sJKFAllReplyPointer->SystemWorkingMinutes);
         Serial.print(F(" -> "));
         Serial.println(sUpTimeString);
 
         Serial.println(F("*** CELL INFO ***"));
         printJKCellInfo();
 
-        if (sBalancingCount > MINIMUM_BALANCING_COUNT_FOR_DISPLAY) {
+        if (sBalancingTime.Units > MINIMUM_BALANCING_SECONDS_FOR_DISPLAY) {
             Serial.println(F("*** CELL STATISTICS ***"));
             Serial.print(F("Total balancing time="));
 
-            Serial.print(sBalancingCount * (MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS / 1000));
+            Serial.print(sBalancingTime.Units);
             Serial.print(F(" s -> "));
             Serial.print(sBalancingTimeString);
             // Append seconds
             char tString[4]; // "03S" is 3 bytes long
-            sprintf_P(tString, PSTR("%02uS"), (uint16_t) (sBalancingCount % 30) * 2);
+            sprintf_P(tString, PSTR("%02uS"), (uint16_t) (sBalancingTime.Units % 60));
             Serial.println(tString);
             printJKCellStatisticsInfo();
         }
 
 #if !defined(SUPPRESS_LIFEPO4_PLAUSI_WARNING)
-        if (swap(tJKFAllReply->CellOvervoltageProtectionMillivolt) > 3450) {
+        if (tJKFAllReply->CellOvervoltageProtectionMillivolt > 3450) {
             // https://www.evworks.com.au/page/technical-information/lifepo4-care-guide-looking-after-your-lithium-batt/
             Serial.print(F("Warning: CellOvervoltageProtectionMillivolt value "));
-            Serial.print(swap(tJKFAllReply->CellOvervoltageProtectionMillivolt));
+            Serial.print(tJKFAllReply->CellOvervoltageProtectionMillivolt);
             Serial.println(
                     F(" mV > 3450 mV is not recommended for LiFePO4 chemistry. There is less than 1% extra capacity above 3.5V."));
         }
-        if (swap(tJKFAllReply->CellUndervoltageProtectionMillivolt) < 3000) {
+        if (tJKFAllReply->CellUndervoltageProtectionMillivolt < 3000) {
             // https://batteryfinds.com/lifepo4-voltage-chart-3-2v-12v-24v-48v/
             Serial.print(F("Warning: CellUndervoltageProtectionMillivolt value "));
-            Serial.print(swap(tJKFAllReply->CellUndervoltageProtectionMillivolt));
+            Serial.print(tJKFAllReply->CellUndervoltageProtectionMillivolt);
             Serial.println(F(" mV < 3000 mV is not recommended for LiFePO4 chemistry."));
             Serial.println(F("There is less than 10% capacity below 3.0V and 20% capacity below 3.2V."));
         }
@@ -906,16 +1262,12 @@ void printJKDynamicInfo() {
      * Temperatures
      * Print only if temperature changed more than 1 degree
      */
-#if defined(LOCAL_DEBUG)
-    Serial.print(F("TokenTemperaturePowerMosFet=0x"));
-    Serial.println(sJKFAllReplyPointer->TokenTemperaturePowerMosFet, HEX);
-#endif
-    if (abs(JKComputedData.TemperaturePowerMosFet - lastJKComputedData.TemperaturePowerMosFet) > 2
-            || abs(JKComputedData.TemperatureSensor1 - lastJKComputedData.TemperatureSensor1) > 2
-            || abs(JKComputedData.TemperatureSensor2 - lastJKComputedData.TemperatureSensor2) > 2) {
-        myPrint(F("Temperature: Power MosFet="), JKComputedData.TemperaturePowerMosFet);
-        myPrint(F(", Sensor 1="), JKComputedData.TemperatureSensor1);
-        myPrintln(F(", Sensor 2="), JKComputedData.TemperatureSensor2);
+    if (abs(sJKFAllReplyPointer->TemperaturePowerMosFet - lastJKReply.TemperaturePowerMosFet) > 2
+            || abs(sJKFAllReplyPointer->TemperatureSensor1 - lastJKReply.TemperatureSensor1) > 2
+            || abs(sJKFAllReplyPointer->TemperatureSensor2 - lastJKReply.TemperatureSensor2) > 2) {
+        myPrint(F("Temperature: Power MosFet="), sJKFAllReplyPointer->TemperaturePowerMosFet);
+        myPrint(F(", Sensor 1="), sJKFAllReplyPointer->TemperatureSensor1);
+        myPrintln(F(", Sensor 2="), sJKFAllReplyPointer->TemperatureSensor2);
     }
 
     /*
@@ -930,16 +1282,32 @@ void printJKDynamicInfo() {
     /*
      * Charge and Discharge values
      */
+#if defined(USE_FIXED_POINT)
+    if (abs((int16_t) (JKComputedData.BatteryVoltage10Millivolt - lastJKComputedData.BatteryVoltage10Millivolt)) > 2
+#else
     if (abs(JKComputedData.BatteryVoltageFloat - lastJKComputedData.BatteryVoltageFloat) > 0.02 // Meant is 0.02 but use 15 to avoid strange floating point effects
+#endif
     || abs(JKComputedData.BatteryLoadPower - lastJKComputedData.BatteryLoadPower) >= 20) {
         Serial.print(F("Battery Voltage[V]="));
+#if defined(USE_FIXED_POINT)
+        printHundredths(&Serial, JKComputedData.BatteryVoltage10Millivolt, 2);
+        Serial.print(F(", Current[A]="));
+        printHundredths(&Serial, JKComputedData.BatteryLoadCurrent10Milliampere, 2);
+#else
         Serial.print(JKComputedData.BatteryVoltageFloat, 2);
         Serial.print(F(", Current[A]="));
         Serial.print(JKComputedData.BatteryLoadCurrentFloat, 2);
+#endif
         myPrint(F(", Power[W]="), JKComputedData.BatteryLoadPower);
         Serial.print(F(", Difference to full[V]="));
-        float tBatteryToFullDifference = JKComputedData.BatteryFullVoltage10Millivolt - JKComputedData.BatteryVoltage10Millivolt;
+#if defined(USE_FIXED_POINT)
+        printHundredths(&Serial,
+                (int32_t) sJKFAllReplyPointer->BatteryOvervoltageProtection10Millivolt - sJKFAllReplyPointer->Battery10Millivolt, 1);
+        Serial.println();
+#else
+        float tBatteryToFullDifference = sJKFAllReplyPointer->BatteryOvervoltageProtection10Millivolt - sJKFAllReplyPointer->Battery10Millivolt;
         Serial.println(tBatteryToFullDifference / 100.0, 1);
+#endif
     }
 
     /*
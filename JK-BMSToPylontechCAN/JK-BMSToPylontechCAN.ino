@@ -20,13 +20,13 @@
  *  Internal operation (default every 2 seconds):
  *  1. A request to deliver all informations is sent to the BMS (1.85 ms).
  *  2. Wait and receive the BMS status frame (0.18 to 1 ms + 25.5 ms).
- *  3. The BMS status frame is stored in a buffer and parity and other plausi checks are made.
- *  4. The cell data are converted and enhanced to fill the JKConvertedCellInfoStruct.
- *     Other frame data are mapped to a C structure.
- *     But all words and longs in this structure are filled with big endian and thus cannot be read directly but must be swapped on reading.
+ *  3. The BMS status frame is decoded by the receive ISR while receiving, checksum and other plausi checks are made.
+ *     Cell voltages are converted to little endian, other frame data are decoded token by token into the little endian JKReplyStruct,
+ *     temperatures and current are converted to signed values. The raw frame is not stored.
+ *  4. The cell data are enhanced to fill the JKConvertedCellInfoStruct.
  *  5. Other frame data are converted and enhanced to fill the JKComputedDataStruct.
  *  6. The content of the status frame is printed. After reset, all info is printed once, then only dynamic info is printed.
- *  7. The required CAN data is filled in the according PylontechCANFrameInfoStruct.
+ *  7. The required CAN data is filled in the FrameData of the according Pylontech*FrameStruct.
  *  8. Dynamic data and errors are displayed on the optional 2004 LCD if attached.
  *  9. CAN data is sent..
  *
@@ -96,6 +96,7 @@
  * Maximum, minimum cell while balancing
  */
 #include <Arduino.h>
+#include "HardwareSerialTX.h" // Replaces Serial, to be able to receive the JK-BMS reply frame by our own ISR. Must be included before all other files using Serial.
 
 /*
  * If battery SOC is below this value, the inverter is forced to charge the battery from any available power source regardless of inverter settings.
@@ -104,7 +105,7 @@
 //#define SOC_THRESHOLD_FOR_FORCE_CHARGE_REQUEST_I        0 // This disables the setting if the force charge request, even if battery SOC is 0.
 const uint8_t sSOCThresholdForForceCharge = SOC_THRESHOLD_FOR_FORCE_CHARGE_REQUEST_I;
 
-#define VERSION_EXAMPLE "2.3.0"
+#define VERSION_EXAMPLE "2.4.0"
 
 // For controlling charge scheme
 const uint8_t CHARGE_PHASE_1 = 45;            // 45 minutes warming up, charging current will go up in linear mode
@@ -166,11 +167,35 @@ uint8_t ChargeTryEffort = 0;                 // Count of Charge try when battery
 #define SECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS          "1" // Only for display on LCD
 #define SECONDS_BETWEEN_CAN_FRAME_SEND                  "1" // Only for display on LCD
 #else
+//#define USE_FAST_JK_POLLING // Request the next status frame as soon as the last one is processed, but not before the minimum period
+//#define USE_ADAPTIVE_JK_POLLING // Request period between 250 ms and 10 s, depending on current, current change and alarms
+#  if defined(USE_FAST_JK_POLLING)
+#    if !defined(MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS)
+#define MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS 300 // Request and reply take around 26 ms, processing and printing takes the rest
+#    endif
+#define MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS     MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS
+#  elif defined(USE_ADAPTIVE_JK_POLLING)
+/*
+ * Request fast at alarms, high current or fast current change and slow down stepwise if battery is idle
+ */
+#    if !defined(MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS)
+#define MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS 250
+#    endif
+#    if !defined(MILLISECONDS_MAXIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS)
+#define MILLISECONDS_MAXIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS 10000
+#    endif
+#define MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS     2000 // Period if battery is neither idle nor under high load
+#define ADAPTIVE_POLLING_IDLE_CURRENT_10_MILLIAMPERE    50   // 0.5 A. Below this and without balancing, the battery is idle.
+#define ADAPTIVE_POLLING_HIGH_CURRENT_10_MILLIAMPERE    5000 // 50 A
+#define ADAPTIVE_POLLING_CURRENT_CHANGE_10_MILLIAMPERE  500  // 5 A between 2 replies
+#  else
 #define MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS     2000
-#define MILLISECONDS_BETWEEN_CAN_FRAME_SEND             2000
 #define SECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS          "2" // Only for display on LCD
-#define SECONDS_BETWEEN_CAN_FRAME_SEND                  "2" // Only for display on LCD
+#  endif
+#define MILLISECONDS_BETWEEN_CAN_FRAME_SEND             4000 // Period of unchanged status frames. 0x356 is sent 4 times, static frames 1/5 times as often.
+#define SECONDS_BETWEEN_CAN_FRAME_SEND                  "4" // Only for display on LCD
 #endif
+#define MILLISECONDS_MINIMUM_BETWEEN_CAN_FRAME_SEND     500 // If the inverter sends a frame later than this after our last transmission, we send immediately
 
 /*
  * Error beep behavior
@@ -180,14 +205,18 @@ uint8_t ChargeTryEffort = 0;                 // Count of Charge try when battery
 //#define NO_BEEP_ON_ERROR              // If activated, Do not beep on error or timeout.
 //#define ONE_BEEP_ON_ERROR             // If activated, only beep once if error was detected.
 #define BEEP_TIMEOUT_SECONDS        60L // 1 minute, Maximum is 254 seconds = 4 min 14 s
+#define MILLISECONDS_BETWEEN_ERROR_BEEPS    2000 // Independent of the period of JK-BMS data requests
 #define MULTIPLE_BEEPS_WITH_TIMEOUT     // If activated, beep for 1 minute if error was detected. Timeout is disabled if debug is active.
 bool sLastDoErrorBeep = false;          // required for ONE_BEEP_ON_ERROR
 bool sDoErrorBeep = false;              // If true, we do an error beep at the end of the loop
 uint8_t sBeepTimeoutCounter;
+uint32_t sMillisOfLastErrorBeep = -MILLISECONDS_BETWEEN_ERROR_BEEPS; // Initial value to beep at first error
 uint16_t sTimeoutFrameCounter = 0;      // Counts BMS frame timeouts, (every 2 seconds)
 
 //#define SUPPRESS_LIFEPO4_PLAUSI_WARNING   // Disables warning on Serial out about using LiFePO4 beyond 3.0 v to 3.45 V.
 
+//#define USE_FIXED_POINT   // Use scaled integers (10 mV, 10 mA) instead of float for computed values. Saves program space and CPU time.
+
 //#define USE_NO_LCD
 #if !defined(USE_NO_LCD)
 #define USE_SERIAL_LCD
@@ -216,7 +245,7 @@ uint16_t sTimeoutFrameCounter = 0;      // Counts BMS frame timeouts, (every 2 s
 void doLCDBacklightTimeoutHandling();
 bool checkAndTurnLCDOn();
 bool sSerialLCDIsSwitchedOff = false;
-uint16_t sFrameCounterForLCDTAutoOff = 0;
+uint32_t sMillisOfLCDAutoOffStart = 0;  // Time based, so it is independent of the period of JK-BMS data requests
 #  endif
 #endif // defined(USE_LCD)
 
@@ -247,6 +276,7 @@ void handleFrameReceiveTimeout();
 #if !defined(MAXIMUM_NUMBER_OF_CELLS)
 #define MAXIMUM_NUMBER_OF_CELLS     24 // Maximum number of cell info which can be converted. Must be before #include "JK-BMS.hpp".
 #endif
+#include "HardwareSerialTX.hpp"
 #include "JK-BMS.hpp"
 
 /*
@@ -258,8 +288,13 @@ void handleFrameReceiveTimeout();
  * If available, we also can use a second hardware serial here :-).
  */
 SoftwareSerialTX TxToJKBMS(JK_BMS_TX_PIN);
-bool sFrameIsRequested = false;             // If true, request was recently sent so now check for serial input
+bool sFrameIsRequested = false;             // If true, request was recently sent so now check for frame received by ISR
 uint32_t sMillisOfLastRequestedJKDataFrame = -MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS; // Initial value to start first request immediately
+uint16_t sMillisBetweenJKDataFrameRequests = MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS; // Only changed by USE_ADAPTIVE_JK_POLLING
+#if defined(USE_ADAPTIVE_JK_POLLING)
+int16_t sLastBattery10MilliAmpere;          // For current change
+void computeJKDataFrameRequestPeriod();
+#endif
 uint32_t sMillisOfLastReceivedByte = 0;     // For timeout
 
 /*
@@ -275,17 +310,23 @@ uint32_t sMillisOfLastReceivedByte = 0;     // For timeout
 #define MHZ_OF_CRYSTAL_ASSEMBLED_ON_CAN_MODULE  16 // 16 MHz is default for the Arduino CAN bus shield
 //#define MHZ_OF_CRYSTAL_ASSEMBLED_ON_CAN_MODULE   8 // 8 MHz is default for the Chinese breakout board. !!! 8MHz does not work with 500 kB !!!
 #endif
-#include "MCP2515_TX.hpp"                   // my reduced tx only driver
+#include "MCP2515_TX.hpp"                   // my reduced driver
 bool sCANDataIsInitialized = false;         // One time flag, it is never set to false again.
-uint32_t sMillisOfLastCANFrameSent = 0;     // For CAN timing
+uint32_t sMillisOfLastCANFrameSent = 0;     // Sending of any frame. An inverter frame received later than MILLISECONDS_MINIMUM_BETWEEN_CAN_FRAME_SEND triggers sending of all frames
 
 /*
  * Optional sleep stuff
  */
-//#define USE_SLEEP
-#if defined(USE_SLEEP) && MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS == 2000 && MILLISECONDS_BETWEEN_CAN_FRAME_SEND == 2000
-// currently not in the mood to compute it more general ;-)
+//#define USE_SLEEP // Sleep at the end of each loop until the next BMS request or CAN frame is due or the next reply byte is received
+#if defined(USE_SLEEP)
+#define MILLISECONDS_FOR_DUTY_CYCLE_MEASUREMENT 60000 // Period for measuring the ratio of awake time to total time
+uint32_t sMillisOfDutyCycleMeasurementStart = 0;
+uint32_t sMicrosAsleep = 0;                 // Sum of all sleeps in the current measurement period
+uint16_t sAwakePermille = 1000;             // Result of the last complete measurement period
+volatile bool sWakeUpByButton = false;      // Set by ISR(PCINT2_vect), which is only enabled during watchdog sleep
 void LoopDelayWithSleep();
+void sleepIdle();
+void printSleepDutyCycle();
 #include "AVRUtils.h"
 #endif
 
@@ -298,8 +339,14 @@ bool sBMSFrameProcessingComplete = false; // True if one status frame was receiv
 #define LCD_COLUMNS     20
 #define LCD_ROWS         4
 #define LCD_I2C_ADDRESS 0x27     // Default LCD address is 0x27 for a 20 chars and 4 line / 2004 display
+#if !defined(LCD_CHARACTERS_PER_LOOP)
+#define LCD_CHARACTERS_PER_LOOP 10 // Changed characters sent by one loop, a new page is sent by 8 loops. 10 characters take 1.4 ms at 400 kHz.
+#endif
 bool sSerialLCDAvailable;
 
+#if !defined(USE_NO_TWI_TX)
+#define USE_TWI_TX // The LCD bytes are queued and sent by the TWI interrupt. This does not block the loop for the LCD output.
+#endif
 #include "LiquidCrystal_I2C.hpp" // This defines USE_SOFT_I2C_MASTER, if SoftI2CMasterConfig.h is available. Use only the modified version delivered with this program!
 LiquidCrystal_I2C myLCD(LCD_I2C_ADDRESS, LCD_COLUMNS, LCD_ROWS);
 
@@ -314,16 +361,30 @@ LCDBigNumbers bigNumberLCD(&myLCD, BIG_NUMBERS_FONT_2_COLUMN_3_ROWS_VARIANT_2);
 #define UNITS_ROW_FOR_BIG_INFO  1
 const uint8_t bigNumbersTopBlock[8] PROGMEM = { 0x0F, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }; // char 1: top block for maximum cell voltage marker
 const uint8_t bigNumbersBottomBlock[8] PROGMEM = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x0F }; // char 2: bottom block for minimum cell voltage marker
+/*
+ * Custom characters 0 to 7 for JK_BMS_PAGE_CELL_BARS. Character n is a bar of n + 1 pixel rows.
+ */
+#define NUMBER_OF_CELL_BAR_LEVELS   8
+const uint8_t cellBarLevelPatterns[NUMBER_OF_CELL_BAR_LEVELS][8] PROGMEM = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F },
+        { 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F },
+        { 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+        { 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+        { 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+        { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F } };
 
 /*
  * LCD display pages
  */
 #define JK_BMS_PAGE_OVERVIEW            0 // is displayed in case of BMS error message
 #define JK_BMS_PAGE_CELL_INFO           1
-#define JK_BMS_PAGE_CELL_STATISTICS     2
+#define JK_BMS_PAGE_CELL_BARS           2 // Cell voltages as bars between minimum and maximum
+#define JK_BMS_PAGE_CELL_STATISTICS     3
 #define CELL_STATISTICS_COUNTER_MASK 0x04 // must be a multiple of 2 and determines how often one page (min or max) is displayed.
-#define JK_BMS_PAGE_BIG_INFO            3
-#define JK_BMS_PAGE_CAN_INFO            4 // If debug was pressed
+#define JK_BMS_PAGE_BIG_INFO            4
+#define JK_BMS_PAGE_CAN_INFO            5 // If debug was pressed
 #define JK_BMS_PAGE_MAX                 JK_BMS_PAGE_BIG_INFO
 #define JK_BMS_START_PAGE               JK_BMS_PAGE_BIG_INFO
 //uint8_t sLCDDisplayPageNumber = JK_BMS_PAGE_OVERVIEW; // Start with Overview page
@@ -331,6 +392,7 @@ uint8_t sLCDDisplayPageNumber = JK_BMS_START_PAGE; // Start with Big Info page
 uint8_t sCellStatisticsDisplayCounter;    // counter for CELL_STATISTICS_COUNTER_MASK, to determine max or min page
 char sStringBuffer[7];                    // For rendering numbers with sprintf_P()
 void setDisplayPage(uint8_t aDisplayPageNumber);
+void createCustomCharactersForDisplayPage(uint8_t aDisplayPageNumber);
 
 void printBMSDataOnLCD();
 void printCANInfoOnLCD();
@@ -345,6 +407,15 @@ void LCDClearLine(uint8_t aLineNumber);
 #if TIMEOUT_MILLIS_FOR_FRAME_REPLY > MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS
 #error "TIMEOUT_MILLIS_FOR_FRAME_REPLY must be smaller than MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS to detect timeouts"
 #endif
+#if defined(USE_ADAPTIVE_JK_POLLING) && TIMEOUT_MILLIS_FOR_FRAME_REPLY > MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS
+#error "TIMEOUT_MILLIS_FOR_FRAME_REPLY must be smaller than MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS to detect timeouts"
+#endif
+#if MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS + TIMEOUT_MILLIS_FOR_FRAME_REPLY >= MAXIMUM_MILLISECONDS_FOR_STATISTICS
+#error "MAXIMUM_MILLISECONDS_FOR_STATISTICS must be greater than MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS + TIMEOUT_MILLIS_FOR_FRAME_REPLY to count the time between 2 replies"
+#endif
+#if defined(USE_ADAPTIVE_JK_POLLING) && MILLISECONDS_MAXIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS + TIMEOUT_MILLIS_FOR_FRAME_REPLY >= MAXIMUM_MILLISECONDS_FOR_STATISTICS
+#error "MAXIMUM_MILLISECONDS_FOR_STATISTICS must be greater than MILLISECONDS_MAXIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS + TIMEOUT_MILLIS_FOR_FRAME_REPLY to count the time between 2 replies"
+#endif
 bool sStaticInfoWasSent = false; // Flag to send static Info only once after reset.
 
 #if defined(TIMING_TEST)
@@ -361,7 +432,7 @@ void handleOvervoltage();
 #  if defined(LCD_PAGES_TEST)
 //#define BIG_NUMBER_TEST
 #  endif
-const uint8_t TestJKReplyStatusFrame[] PROGMEM = { /* Header*/0x4E, 0x57, 0x01, 0x2D, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x01,
+const uint8_t TestJKReplyStatusFrame[] PROGMEM = { /* Header*/0x4E, 0x57, 0x01, 0x21, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x01,
 /*Length of Cell voltages*/
 0x79, 0x30,
 /*Cell voltages*/
@@ -382,9 +453,11 @@ const uint8_t TestJKReplyStatusFrame[] PROGMEM = { /* Header*/0x4E, 0x57, 0x01,
         0xBA, 0x49, 0x6E, 0x70, 0x75, 0x74, 0x20, 0x55, 0x73, 0x65, 0x72, 0x64, 0x61, 0x4A, 0x4B, 0x5F, 0x42, 0x32, 0x41, 0x32,
         0x30, 0x53, 0x32, 0x30, 0x50, 0xC0, 0x01,
         /*Trailer*/
-        0x00, 0x00, 0x00, 0x00, 0x68, 0x00, 0x00, 0x51, 0xC2 };
+        0x00, 0x00, 0x00, 0x00, 0x68, 0x00, 0x00, 0x57, 0x43 };
 
+void receiveTestJKReplyStatusFrame();
 void doStandaloneTest();
+void setTestBatteryLoadCurrentFromPower();
 void testLCDPages();
 void testBigNumbers();
 #endif
@@ -406,6 +479,7 @@ void setup() {
 #endif
 
     Serial.begin(115200);
+    enableJKReplyFrameReceiveInterrupt();
 #if defined(__AVR_ATmega32U4__) || defined(SERIAL_PORT_USBVIRTUAL) || defined(SERIAL_USB) /*stm32duino*/|| defined(USBCON) /*STM32_stm32*/|| defined(SERIALUSB_PID) || defined(ARDUINO_attiny3217)
 delay(4000); // To be able to connect Serial monitor after reset or power up and before first print out. Do not wait for an attached Serial Monitor!
 #endif
@@ -439,7 +513,7 @@ delay(4000); // To be able to connect Serial monitor after reset or power up and
         myLCD.print(F("JK-BMS to CAN conv."));
         myLCD.setCursor(0, 1);
         myLCD.print(F(VERSION_EXAMPLE " " __DATE__));
-        bigNumberLCD.begin(); // This creates the custom character used for printing big numbers
+        createCustomCharactersForDisplayPage(sLCDDisplayPageNumber);
 
     } else {
         Serial.println(F("No I2C LCD connected at address " STR(LCD_I2C_ADDRESS)));
@@ -467,6 +541,7 @@ delay(4000); // To be able to connect Serial monitor after reset or power up and
         if (sSerialLCDAvailable) {
             myLCD.setCursor(0, 3);
             myLCD.print(F("CAN started"));
+            myLCD.flush();
             delay(4000); // To see the info
         }
 #endif
@@ -477,8 +552,10 @@ delay(4000); // To be able to connect Serial monitor after reset or power up and
             myLCD.setCursor(0, 3);
             myLCD.print(F("Starting CAN failed!"));
 #  if defined(STANDALONE_TEST)
+            myLCD.flush();
             delay(2000);
 #  else
+            myLCD.flush();
             delay(8000); // To see the info
 #  endif
         }
@@ -496,8 +573,15 @@ delay(4000); // To be able to connect Serial monitor after reset or power up and
     Serial.println(F("Debug button is at pin " STR(LCD_PAGE_BUTTON_PIN)));
     Serial.println(F("Additional debug data is printed as long as button is pressed"));
 #endif
+#if defined(USE_FAST_JK_POLLING)
+    Serial.println(F("Request BMS after processing of last reply, minimum " STR(MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS) " ms between 2 BMS requests"));
+#elif defined(USE_ADAPTIVE_JK_POLLING)
+    Serial.println(F(STR(MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS) " to " STR(MILLISECONDS_MAXIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS) " ms between 2 BMS requests, depending on current and alarms"));
+#else
     Serial.println(F(STR(MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS) " ms between 2 BMS requests"));
-    Serial.println(F(STR(MILLISECONDS_BETWEEN_CAN_FRAME_SEND) " ms between 2 CAN transmissions"));
+#endif
+    Serial.println(F(STR(MILLISECONDS_BETWEEN_CAN_FRAME_SEND) " ms between 2 CAN transmissions of unchanged status frames"));
+    Serial.println(F("Send earlier, if inverter frame is received at least " STR(MILLISECONDS_MINIMUM_BETWEEN_CAN_FRAME_SEND) " ms after last transmission"));
 #if defined(USE_LCD) && !defined(DISPLAY_ALWAYS_ON)
     Serial.println(F("LCD Backlight timeout is " DISPLAY_ON_TIME_STRING));
 #endif
@@ -514,11 +598,16 @@ delay(4000); // To be able to connect Serial monitor after reset or power up and
         myLCD.setCursor(0, 2);
 #if defined(STANDALONE_TEST)
         myLCD.print(F("Test -fixed BMS data"));
+#elif defined(USE_FAST_JK_POLLING)
+        myLCD.print(F("Get  BMS min " STR(MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS) " ms"));
+#elif defined(USE_ADAPTIVE_JK_POLLING)
+        myLCD.print(F("Get  BMS adaptive"));
 #else
         myLCD.print(F("Get  BMS every " SECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS " s  "));
 #endif
         myLCD.setCursor(0, 3);
         myLCD.print(F("Send CAN every " SECONDS_BETWEEN_CAN_FRAME_SEND " s  "));
+        myLCD.flush();
         delay(2000); // To see the messages
         myLCD.clear();
     }
@@ -530,21 +619,18 @@ delay(4000); // To be able to connect Serial monitor after reset or power up and
 
 #if defined(STANDALONE_TEST)
     /*
-     * Copy test data to receive buffer
+     * Decode test data like received data
      */
     Serial.println(F("Standalone test. Use fixed demo data"));
     Serial.println();
-    memcpy_P(JKReplyFrameBuffer, TestJKReplyStatusFrame, sizeof(TestJKReplyStatusFrame));
-    sReplyFrameBufferIndex = sizeof(TestJKReplyStatusFrame) - 1;
-    printJKReplyFrameBuffer();
-    Serial.println();
+    receiveTestJKReplyStatusFrame();
     processReceivedData();
     printReceivedData();
     /*
-     * Copy complete reply and computed values for change determination
+     * Copy computed values and values of reply for change determination
      */
     lastJKComputedData = JKComputedData;
-    lastJKReply = *sJKFAllReplyPointer; // 221 bytes
+    storeJKReplyForChangeDetection();
     doStandaloneTest();
 #endif
 }
@@ -554,16 +640,17 @@ void loop() {
     checkButtonPress();
 
     /*
-     * Request status frame every 2 seconds
+     * Request status frame every 2 seconds or in fast and adaptive polling mode, not before the last frame is processed
      */
-    if (millis() - sMillisOfLastRequestedJKDataFrame >= MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS) {
+    if (millis() - sMillisOfLastRequestedJKDataFrame >= sMillisBetweenJKDataFrameRequests
+#if defined(USE_FAST_JK_POLLING) || defined(USE_ADAPTIVE_JK_POLLING)
+            && !sFrameIsRequested
+#endif
+            ) {
         sMillisOfLastRequestedJKDataFrame = millis(); // set for next check
         /*
-         * Flush input buffer and send request to JK-BMS
+         * Send request to JK-BMS. Bytes received before are ignored by ISR.
          */
-        while (Serial.available()) {
-            Serial.read();
-        }
 #if defined(TIMING_TEST)
         digitalWriteFast(TIMING_TEST_PIN, HIGH);
 #endif
@@ -571,8 +658,8 @@ void loop() {
 #if defined(TIMING_TEST)
         digitalWriteFast(TIMING_TEST_PIN, LOW);
 #endif
-        sFrameIsRequested = true; // enable check for serial input
-        initJKReplyFrameBuffer();
+        sFrameIsRequested = true; // enable check for frame received by ISR
+        initJKReplyFrameReceiving();
         sMillisOfLastReceivedByte = millis(); // initialize reply timeout
     }
 
@@ -586,7 +673,11 @@ void loop() {
      * Get reply from BMS and check timeout
      */
     if (sFrameIsRequested) {
-        if (Serial.available()) {
+        if (sJKBMSByteWasReceived) {
+            sJKBMSByteWasReceived = false;
+            sMillisOfLastReceivedByte = millis();
+        }
+        if (sJKBMSReceiveStatus != JK_BMS_RECEIVE_OK) {
 #  if defined(TIMING_TEST)
             digitalWriteFast(TIMING_TEST_PIN, HIGH);
 #  endif
@@ -599,7 +690,7 @@ void loop() {
 
         } else if (millis() - sMillisOfLastReceivedByte >= TIMEOUT_MILLIS_FOR_FRAME_REPLY) {
             /*
-             * Here we have requested frame, but serial was not available fore a longer time => timeout at receiving
+             * Here we have requested frame, but ISR received no byte for a longer time => timeout at receiving
              * If no bytes received before (because of BMS disconnected), print it only once
              */
             handleFrameReceiveTimeout();
@@ -608,20 +699,39 @@ void loop() {
 #endif // !defined(STANDALONE_TEST)
 
     /*
-     * Send CAN frame independently of the period of JK-BMS data requests
+     * Send CAN frames independently of the period of JK-BMS data requests, each frame with its own period of PylontechCANSchedule[]
      * 0.5 MB/s
      * Inverter reply every second: 0x305: 00-00-00-00-00-00-00-00
+     * If the inverter polls with its own period, we send all frames and follow it. Its reply to our frames arrives too early to trigger a transmission.
      * Do not send, if BMS is starting up, the 0% SOC during this time will trigger a deye error beep.
      */
-    if (sCANDataIsInitialized && !JKComputedData.BMSIsStarting
-            && millis() - sMillisOfLastCANFrameSent >= MILLISECONDS_BETWEEN_CAN_FRAME_SEND) {
-        sMillisOfLastCANFrameSent = millis();
+    bool tInverterFrameReceived = handleInverterCANFrames(sMillisOfLastCANFrameSent);
+    if (sCANDataIsInitialized && !JKComputedData.BMSIsStarting) {
+        if (tInverterFrameReceived && millis() - sMillisOfLastCANFrameSent >= MILLISECONDS_MINIMUM_BETWEEN_CAN_FRAME_SEND) {
+            sMillisOfLastCANFrameSent = millis();
 
-        if (sDebugModeActivated) {
-            Serial.println(F("Send CAN"));
+            if (sDebugModeActivated) {
+                Serial.println(F("Send CAN"));
+            }
+            sendPylontechAllCANFrames(sDebugModeActivated);
+        } else {
+            if (sBMSFrameProcessingComplete) {
+                /*
+                 * New BMS data or timeout. Send changed alarms and requests immediately and not in their next slot.
+                 */
+                schedulePylontechChangedCANFrames();
+            }
+            if (handlePylontechCANSchedule(sDebugModeActivated)) {
+                sMillisOfLastCANFrameSent = millis(); // The inverter reply to this frame must not trigger sending of all frames
+            }
         }
-        sendPylontechAllCANFrames(sDebugModeActivated);
+    } else {
+        sPylontechCANScheduleIsStarted = false; // Start with the offsets again, if sending is enabled
     }
+    /*
+     * The frames are only queued above, here they are loaded into the free MCP2515 TX buffers without waiting for the CAN bus
+     */
+    handleCANTransmitQueue();
 
     /*
      * Do this once after each complete status frame or timeout
@@ -681,13 +791,19 @@ void loop() {
             sLastDoErrorBeep = sDoErrorBeep; // Reset sLastDoErrorBeep
         }
 #  endif
-        if (sDoErrorBeep) {
-            sDoErrorBeep = false;
+        /*
+         * Use the request time as time of beep, it has no jitter of the reply time
+         */
+        bool tDoErrorBeep = sDoErrorBeep
+                && sMillisOfLastRequestedJKDataFrame - sMillisOfLastErrorBeep >= MILLISECONDS_BETWEEN_ERROR_BEEPS;
+        sDoErrorBeep = false;
+        if (tDoErrorBeep) {
+            sMillisOfLastErrorBeep = sMillisOfLastRequestedJKDataFrame;
 #  if defined(MULTIPLE_BEEPS_WITH_TIMEOUT) && !defined(ONE_BEEP_ON_ERROR)   // Beep one minute
             sBeepTimeoutCounter++;
-            if (sBeepTimeoutCounter == (BEEP_TIMEOUT_SECONDS * 1000U) / MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS) {
+            if (sBeepTimeoutCounter == (BEEP_TIMEOUT_SECONDS * 1000U) / MILLISECONDS_BETWEEN_ERROR_BEEPS) {
                 Serial.println(F("Timeout reached, suppress consecutive error beeps"));
-            } else if (sBeepTimeoutCounter > (BEEP_TIMEOUT_SECONDS * 1000U) / MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS) {
+            } else if (sBeepTimeoutCounter > (BEEP_TIMEOUT_SECONDS * 1000U) / MILLISECONDS_BETWEEN_ERROR_BEEPS) {
                 sBeepTimeoutCounter--; // To avoid overflow
             } else
 #  endif
@@ -703,14 +819,24 @@ void loop() {
 #endif // NO_BEEP_ON_ERROR
 
         sBMSFrameProcessingComplete = false; // prepare for next loop
+    } // if (sBMSFrameProcessingComplete)
+
+#if defined(USE_LCD)
+    /*
+     * Send only the characters, which were changed by the LCD prints, and not more than LCD_CHARACTERS_PER_LOOP,
+     * to bound the duration of a loop. The remaining characters are sent by the next loops.
+     */
+    if (sSerialLCDAvailable) {
+        myLCD.flush(LCD_CHARACTERS_PER_LOOP);
+    }
+#endif
 
 #if defined(USE_SLEEP)
-        /*
-         * Sleep instead of checking millis(). This saves only 5 mA during sleep.
-         */
-        void LoopDelayWithSleep();
+    /*
+     * Sleep instead of checking millis() in the next loop
+     */
+    LoopDelayWithSleep();
 #endif // defined(USE_SLEEP)
-    } // if (sBMSFrameProcessingComplete)
 }
 
 /*
@@ -718,16 +844,9 @@ void loop() {
  */
 void processJK_BMSStatusFrame() {
     if (sDebugModeActivated) {
-        /*
-         * Do it once at every debug start
-         */
-        if (sReplyFrameBufferIndex == 0) {
-            Serial.println(F("sReplyFrameBufferIndex is 0"));
-        } else {
-            Serial.print(sReplyFrameBufferIndex + 1);
-            Serial.println(F(" bytes received"));
-            printJKReplyFrameBuffer();
-        }
+        Serial.print(sReplyFrameIndex + 1);
+        Serial.print(F(" bytes received, checksum=0x"));
+        Serial.println(sJKBMSFrameChecksum, HEX);
         Serial.println();
     }
 
@@ -743,23 +862,31 @@ void processJK_BMSStatusFrame() {
         }
 #endif
     }
+    useReceivedJKReply();
     processReceivedData();
     printReceivedData();
+#if defined(USE_ADAPTIVE_JK_POLLING)
+    computeJKDataFrameRequestPeriod();
+#endif
+#if defined(USE_SLEEP)
+    if (sDebugModeActivated) {
+        printSleepDutyCycle();
+    }
+#endif
     /*
-     * Copy complete reply and computed values for change determination
+     * Copy computed values and values of reply for change determination
      */
     lastJKComputedData = JKComputedData;
-    lastJKReply = *sJKFAllReplyPointer; // 221 bytes
+    storeJKReplyForChangeDetection();
 }
 
 /*
- * Reads all bytes of the requested frame into buffer and prints errors
- * Sets sFrameIsRequested to false, if frame was complete and manages other flags too
- * @return true if frame was completely received
+ * Checks the frame received by ISR and prints errors
+ * Sets sFrameIsRequested to false, if frame has errors and manages other flags too
+ * @return true if frame was completely and successfully received
  */
 bool readJK_BMSStatusFrame() {
-    sMillisOfLastReceivedByte = millis();
-    uint8_t tReceiveResultCode = readJK_BMSStatusFrameByte();
+    uint8_t tReceiveResultCode = checkJK_BMSStatusFrame();
     if (tReceiveResultCode == JK_BMS_RECEIVE_FINISHED) {
         /*
          * All JK-BMS status frame data received
@@ -773,33 +900,31 @@ bool readJK_BMSStatusFrame() {
         Serial.print(F("Receive error="));
         Serial.print(tReceiveResultCode);
         Serial.print(F(" at index"));
-        Serial.println(sReplyFrameBufferIndex);
+        Serial.println(sReplyFrameIndex);
         sFrameIsRequested = false; // do not try to receive more
         sBMSFrameProcessingComplete = true;
-        printJKReplyFrameBuffer();
     }
     return false;
 }
 
 /*
- * Here we have requested frame, but serial was not available fore a longer time => timeout at receiving
+ * Here we have requested frame, but ISR received no byte for a longer time => timeout at receiving
  * If no bytes received before (because of BMS disconnected), print it only once
  */
 void handleFrameReceiveTimeout() {
+    sJKBMSReceiveStatus = JK_BMS_RECEIVE_ERROR; // Stop ISR from decoding late bytes
     sDoErrorBeep = true;
     sFrameIsRequested = false; // Do not try to receive more
     sBMSFrameProcessingComplete = true;
     sJKBMSFrameHasTimeout = true;
-    if (sReplyFrameBufferIndex != 0 || sTimeoutFrameCounter == 0) {
+    sMillisBetweenJKDataFrameRequests = MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS; // Detect reconnect of BMS with the normal period
+    if (sReplyFrameIndex != 0 || sTimeoutFrameCounter == 0) {
         /*
          * No byte received here -BMS may be off or disconnected
          * Do it only once if we receive 0 bytes
          */
-        Serial.print(F("Receive timeout at ReplyFrameBufferIndex="));
-        Serial.println(sReplyFrameBufferIndex);
-        if (sReplyFrameBufferIndex != 0) {
-            printJKReplyFrameBuffer();
-        }
+        Serial.print(F("Receive timeout at ReplyFrameIndex="));
+        Serial.println(sReplyFrameIndex);
         modifyAllCanDataToInactive();
 #if defined(USE_LCD)
         if (sSerialLCDAvailable && sLCDDisplayPageNumber == JK_BMS_PAGE_CAN_INFO) {
@@ -839,20 +964,20 @@ void handleFrameReceiveTimeout() {
 #endif
 }
 
+/*
+ * Process the data of sJKFAllReplyPointer and the cell info converted by the receive ISR
+ */
 void processReceivedData() {
-    /*
-     * Set the static pointer to the start of the reply data which depends on the number of cell voltage entries
-     * The JKFrameAllDataStruct starts behind the header + cell data header 0x79 + CellInfoSize + the variable length cell data (CellInfoSize is contained in JKReplyFrameBuffer[12])
-     */
-    sJKFAllReplyPointer = reinterpret_cast<JKReplyStruct*>(&JKReplyFrameBuffer[JK_BMS_FRAME_HEADER_LENGTH + 2
-            + JKReplyFrameBuffer[JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH]]);
-
     fillJKConvertedCellInfo();
     fillJKComputedData();
 
     handleAndPrintAlarmInfo();
     computeUpTimeString();
 
+    if (checkJKStaticDataChange()) {
+        fillAllStaticCANData(sJKFAllReplyPointer);
+        sStaticInfoWasSent = false; // print changed configuration
+    }
     fillAllCANData(sJKFAllReplyPointer);
     sCANDataIsInitialized = true; // One time flag
 }
@@ -874,6 +999,42 @@ void printReceivedData() {
 #endif
 }
 
+#if defined(USE_ADAPTIVE_JK_POLLING)
+/*
+ * Called after each successfully processed reply.
+ * Request with minimum period at alarms, high current or fast current change.
+ * If battery is idle, double the period up to the maximum, otherwise use the normal period.
+ */
+void computeJKDataFrameRequestPeriod() {
+    int16_t tBattery10MilliAmpere = sJKFAllReplyPointer->Battery10MilliAmpere;
+    int32_t tCurrentChange10MilliAmpere = (int32_t) tBattery10MilliAmpere - sLastBattery10MilliAmpere;
+    sLastBattery10MilliAmpere = tBattery10MilliAmpere;
+
+    if (sJKFAllReplyPointer->AlarmUnion.AlarmsAsWord != 0 || abs(tBattery10MilliAmpere) >= ADAPTIVE_POLLING_HIGH_CURRENT_10_MILLIAMPERE
+            || abs(tCurrentChange10MilliAmpere) >= ADAPTIVE_POLLING_CURRENT_CHANGE_10_MILLIAMPERE) {
+        sMillisBetweenJKDataFrameRequests = MILLISECONDS_MINIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS;
+
+    } else if (abs(tBattery10MilliAmpere) < ADAPTIVE_POLLING_IDLE_CURRENT_10_MILLIAMPERE
+            && !sJKFAllReplyPointer->BMSStatus.StatusBits.BalancerActive) {
+        if (sMillisBetweenJKDataFrameRequests < MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS) {
+            sMillisBetweenJKDataFrameRequests = MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS;
+        } else if (sMillisBetweenJKDataFrameRequests < MILLISECONDS_MAXIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS / 2) {
+            sMillisBetweenJKDataFrameRequests *= 2;
+        } else {
+            sMillisBetweenJKDataFrameRequests = MILLISECONDS_MAXIMUM_BETWEEN_JK_DATA_FRAME_REQUESTS;
+        }
+
+    } else {
+        sMillisBetweenJKDataFrameRequests = MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS;
+    }
+    if (sDebugModeActivated) {
+        Serial.print(F("Next BMS request in "));
+        Serial.print(sMillisBetweenJKDataFrameRequests);
+        Serial.println(F(" ms"));
+    }
+}
+#endif
+
 #if defined(USE_LCD)
 #  if !defined(DISPLAY_ALWAYS_ON)
 
@@ -883,7 +1044,7 @@ void printReceivedData() {
  * @return true if LCD was switched off before
  */
 bool checkAndTurnLCDOn() {
-    sFrameCounterForLCDTAutoOff = 0; // Always start again to enable backlight switch off after 5 minutes
+    sMillisOfLCDAutoOffStart = millis(); // Always start again to enable backlight switch off after 5 minutes
 
     if (sSerialLCDIsSwitchedOff) {
         /*
@@ -900,12 +1061,7 @@ bool checkAndTurnLCDOn() {
  * Display backlight handling
  */
 void doLCDBacklightTimeoutHandling() {
-    sFrameCounterForLCDTAutoOff++;
-    if (sFrameCounterForLCDTAutoOff == 0) {
-        sFrameCounterForLCDTAutoOff--; // To avoid overflow, we have an unsigned integer here
-    }
-
-    if (sFrameCounterForLCDTAutoOff == (DISPLAY_ON_TIME_SECONDS * 1000U) / MILLISECONDS_BETWEEN_JK_DATA_FRAME_REQUESTS) {
+    if (!sSerialLCDIsSwitchedOff && millis() - sMillisOfLCDAutoOffStart >= DISPLAY_ON_TIME_SECONDS * 1000) {
         myLCD.noBacklight(); // switch off backlight after 5 minutes
         sSerialLCDIsSwitchedOff = true;
         Serial.println(F("Switch off LCD display, triggered by LCD \"ON\" timeout reached."));
@@ -987,7 +1143,11 @@ void printLongStateOnLCD() {
  * Print current as 5 character including sign
  */
 void printCurrentOnLCD() {
-    int16_t tBattery10MilliAmpere = JKComputedData.Battery10MilliAmpere;
+#if defined(USE_FIXED_POINT)
+    int16_t tBattery10MilliAmpere = JKComputedData.BatteryLoadCurrent10Milliampere;
+#else
+    int16_t tBattery10MilliAmpere = sJKFAllReplyPointer->Battery10MilliAmpere;
+#endif
     if (tBattery10MilliAmpere >= 0) {
         myLCD.print(' '); // handle not printed + sign
     }
@@ -1001,7 +1161,11 @@ void printCurrentOnLCD() {
     } else {
         tNumberOfDecimalPlaces = 0; // -9999
     }
+#if defined(USE_FIXED_POINT)
+    printHundredths(&myLCD, JKComputedData.BatteryLoadCurrent10Milliampere, tNumberOfDecimalPlaces);
+#else
     myLCD.print(JKComputedData.BatteryLoadCurrentFloat, tNumberOfDecimalPlaces);
+#endif
     myLCD.print(F("A "));
 }
 
@@ -1040,6 +1204,52 @@ void printCellInfoOnLCD() {
     }
 }
 
+/*
+ * Shows every cell as a bar of 1 to 8 pixel rows, scaled between minimum and maximum cell voltage. 20 cells per row.
+ * The page is printed completely for each BMS frame, but the shadow buffer of LiquidCrystal_I2C sends only the changed bars.
+ */
+void printCellBarsOnLCD() {
+    myLCD.print(F("Cell "));
+    myLCD.print(JKConvertedCellInfo.MinimumCellMillivolt);
+    myLCD.print('-');
+    myLCD.print(JKConvertedCellInfo.MaximumCellMillivolt);
+    myLCD.print(F(" mV"));
+
+    uint16_t tDeltaMillivolt = 0; // Minimum is 0xFFFF and maximum is 0, if all cells have 0 mV
+    if (JKConvertedCellInfo.MaximumCellMillivolt > JKConvertedCellInfo.MinimumCellMillivolt) {
+        tDeltaMillivolt = JKConvertedCellInfo.MaximumCellMillivolt - JKConvertedCellInfo.MinimumCellMillivolt;
+    }
+    uint_fast8_t tRowNumber = 1;
+    for (uint8_t i = 0; i < JKConvertedCellInfo.ActualNumberOfCellInfoEntries; ++i) {
+        if (i % LCD_COLUMNS == 0) {
+            myLCD.setCursor(0, tRowNumber);
+            tRowNumber++;
+        }
+        uint16_t tCellMillivolt = JKConvertedCellInfo.CellInfoStructArray[i].CellMillivolt;
+        if (tCellMillivolt == 0) {
+            myLCD.print(' '); // 0 mV cells are not included in minimum and maximum
+            continue;
+        }
+        uint8_t tLevel = NUMBER_OF_CELL_BAR_LEVELS - 1; // All cells are equal
+        if (tDeltaMillivolt != 0) {
+            uint32_t tScaledLevel = 0;
+            if (tCellMillivolt > JKConvertedCellInfo.MinimumCellMillivolt) {
+                tScaledLevel = (((uint32_t) (tCellMillivolt - JKConvertedCellInfo.MinimumCellMillivolt)
+                        * (NUMBER_OF_CELL_BAR_LEVELS - 1)) + (tDeltaMillivolt / 2)) / tDeltaMillivolt;
+            }
+            if (tScaledLevel < NUMBER_OF_CELL_BAR_LEVELS - 1) {
+                tLevel = tScaledLevel;
+            }
+        }
+        myLCD.write(tLevel); // Custom character 0 to 7
+    }
+
+    myLCD.setCursor(0, 3);
+    myLCD.print(F("Delta "));
+    myLCD.print(JKConvertedCellInfo.DeltaCellMillivolt);
+    myLCD.print(F(" mV"));
+}
+
 /*
  * Switch between display of minimum and maximum at each 4. call
  * The sum of percentages may not give 100% because of rounding errors
@@ -1065,14 +1275,17 @@ void printCellStatisticsOnLCD() {
         tRowNumber = 1;
     }
 
+    uint16_t *tCellStatisticsArray;
+    if (tDisplayCellMinimumStatistics) {
+        tCellStatisticsArray = CellMinimumArray;
+    } else {
+        tCellStatisticsArray = CellMaximumArray;
+    }
+    uint32_t tCellStatisticsSum = getCellStatisticsSum(tCellStatisticsArray);
+
     char *tBalancingTimeStringPtr = &sBalancingTimeString[0];
     for (uint8_t i = 0; i < tNumberOfCellInfoEntries; ++i) {
-        uint8_t tPercent;
-        if (tDisplayCellMinimumStatistics) {
-            tPercent = CellMinimumPercentageArray[i];
-        } else {
-            tPercent = CellMaximumPercentageArray[i];
-        }
+        uint8_t tPercent = getCellStatisticsPercentage(tCellStatisticsArray[i], tCellStatisticsSum);
         if (tPercent < 10) {
             myLCD.print(' ');
         }
@@ -1133,8 +1346,19 @@ void printBigInfoOnLCD() {
      */
     if (tBatteryLoadPower >= 1000 || tBatteryLoadPower <= -1000) {
         tKiloWattChar = 'k';
+#if defined(USE_FIXED_POINT)
+        // convert to 10 W and print like dtostrf(kW, 5, 2, sStringBuffer)
+        if (tBatteryLoadPower < 0) {
+            tBatteryLoadPower = (tBatteryLoadPower - 5) / 10;
+            sprintf_P(sStringBuffer, PSTR("-%d.%02d"), -tBatteryLoadPower / 100, -tBatteryLoadPower % 100);
+        } else {
+            tBatteryLoadPower = (tBatteryLoadPower + 5) / 10;
+            sprintf_P(sStringBuffer, PSTR("%2d.%02d"), tBatteryLoadPower / 100, tBatteryLoadPower % 100);
+        }
+#else
         float tBatteryLoadPowerFloat = tBatteryLoadPower * 0.001; // convert to kW
         dtostrf(tBatteryLoadPowerFloat, 5, 2, sStringBuffer);
+#endif
     } else {
         sprintf_P(sStringBuffer, PSTR("%d"), JKComputedData.BatteryLoadPower);
     }
@@ -1195,14 +1419,18 @@ void printBigInfoOnLCD() {
     printCurrentOnLCD();
 
     myLCD.setCursor(11, 3);
-    uint16_t tBatteryToFullDifference10Millivolt = JKComputedData.BatteryFullVoltage10Millivolt
-            - JKComputedData.BatteryVoltage10Millivolt;
+    uint16_t tBatteryToFullDifference10Millivolt = sJKFAllReplyPointer->BatteryOvervoltageProtection10Millivolt
+            - sJKFAllReplyPointer->Battery10Millivolt;
     if (tBatteryToFullDifference10Millivolt < 100) {
         // Print small values as ".43" instead of "0.4"
         sprintf_P(sStringBuffer, PSTR(".%02d"), tBatteryToFullDifference10Millivolt);
         myLCD.print(sStringBuffer);
     } else {
+#if defined(USE_FIXED_POINT)
+        printHundredths(&myLCD, tBatteryToFullDifference10Millivolt, 1);
+#else
         myLCD.print(((float) tBatteryToFullDifference10Millivolt) / 100.0, 1);
+#endif
     }
     myLCD.print('V');
 
@@ -1223,9 +1451,8 @@ void printCANInfoOnLCD() {
             myLCD.print(F("No BMS data received"));
         }
     } else {
-        PylontechCANFrameStruct *tCANFrameDataPointer =
-                reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANErrorsWarningsFrame);
-        if (tCANFrameDataPointer->FrameData.ULong.LowLong == 0) {
+        uint8_t *tCANFrameDataPointer = reinterpret_cast<uint8_t*>(&PylontechCANErrorsWarningsFrame.FrameData);
+        if ((tCANFrameDataPointer[0] | tCANFrameDataPointer[1] | tCANFrameDataPointer[2] | tCANFrameDataPointer[3]) == 0) {
             /*
              * Caption in row 1 and "No errors / warnings" in row 2
              */
@@ -1243,14 +1470,14 @@ void printCANInfoOnLCD() {
              * Errors in row 1 and warnings in row 2
              */
             myLCD.print(F("Errors: 0x"));
-            myLCD.print(tCANFrameDataPointer->FrameData.UBytes[0], HEX);
+            myLCD.print(tCANFrameDataPointer[0], HEX);
             myLCD.print(F(" 0x"));
-            myLCD.print(tCANFrameDataPointer->FrameData.UBytes[1], HEX);
+            myLCD.print(tCANFrameDataPointer[1], HEX);
             myLCD.setCursor(0, 1);
             myLCD.print(F("Warnings: 0x"));
-            myLCD.print(tCANFrameDataPointer->FrameData.UBytes[2], HEX);
+            myLCD.print(tCANFrameDataPointer[2], HEX);
             myLCD.print(F(" 0x"));
-            myLCD.print(tCANFrameDataPointer->FrameData.UBytes[3], HEX);
+            myLCD.print(tCANFrameDataPointer[3], HEX);
         }
         /*
          * Voltage, current and maximum temperature in row 3
@@ -1351,7 +1578,11 @@ void printOverwiewInfoOnLCD() {
      */
     myLCD.setCursor(0, 2);
 // Voltage
+#if defined(USE_FIXED_POINT)
+    printHundredths(&myLCD, JKComputedData.BatteryVoltage10Millivolt, 2);
+#else
     myLCD.print(JKComputedData.BatteryVoltageFloat, 2);
+#endif
     myLCD.print(F("V "));
 // Current
     printCurrentOnLCD();
@@ -1371,11 +1602,11 @@ void printOverwiewInfoOnLCD() {
      */
     myLCD.setCursor(0, 3);
 // 3 temperatures
-    myLCD.print(JKComputedData.TemperaturePowerMosFet);
+    myLCD.print(sJKFAllReplyPointer->TemperaturePowerMosFet);
     myLCD.print(F("\xDF" "C "));
-    myLCD.print(JKComputedData.TemperatureSensor1);
+    myLCD.print(sJKFAllReplyPointer->TemperatureSensor1);
     myLCD.print(F("\xDF" "C "));
-    myLCD.print(JKComputedData.TemperatureSensor2);
+    myLCD.print(sJKFAllReplyPointer->TemperatureSensor2);
     myLCD.print(F("\xDF" "C "));
 // Last 4 characters are the actual states
     myLCD.setCursor(16, 3);
@@ -1393,6 +1624,9 @@ void printBMSDataOnLCD() {
     } else if (sLCDDisplayPageNumber == JK_BMS_PAGE_CELL_INFO) {
         printCellInfoOnLCD();
 
+    } else if (sLCDDisplayPageNumber == JK_BMS_PAGE_CELL_BARS) {
+        printCellBarsOnLCD();
+
     } else if (sLCDDisplayPageNumber == JK_BMS_PAGE_CELL_STATISTICS) {
         printCellStatisticsOnLCD();
 
@@ -1404,8 +1638,27 @@ void printBMSDataOnLCD() {
     }
 }
 
+/*
+ * Declares the custom characters used by each page.
+ * LiquidCrystal_I2C uploads only the characters, which are not already in the CGRAM of the LCD.
+ */
+void createCustomCharactersForDisplayPage(uint8_t aDisplayPageNumber) {
+    if (aDisplayPageNumber == JK_BMS_PAGE_CELL_INFO) {
+        // Symbols character for maximum and minimum
+        bigNumberLCD._createChar(1, bigNumbersTopBlock);
+        bigNumberLCD._createChar(2, bigNumbersBottomBlock);
+    } else if (aDisplayPageNumber == JK_BMS_PAGE_CELL_BARS) {
+        for (uint_fast8_t i = 0; i < NUMBER_OF_CELL_BAR_LEVELS; i++) {
+            bigNumberLCD._createChar(i, cellBarLevelPatterns[i]);
+        }
+    } else if (aDisplayPageNumber == JK_BMS_PAGE_BIG_INFO) {
+        bigNumberLCD.begin(); // Creates custom character used for generating big numbers
+    }
+}
+
 void setDisplayPage(uint8_t aDisplayPageNumber) {
     sLCDDisplayPageNumber = aDisplayPageNumber;
+    createCustomCharactersForDisplayPage(aDisplayPageNumber);
     tone(BUZZER_PIN, 2200, 30);
     Serial.print(F("Set LCD display page to: "));
     Serial.println(aDisplayPageNumber);
@@ -1460,15 +1713,8 @@ void checkButtonPress() {
                     tDisplayPageNumber = JK_BMS_PAGE_OVERVIEW;
 
                 } else if (tDisplayPageNumber == JK_BMS_PAGE_CELL_INFO) {
-                    // Create symbols character for maximum and minimum
-                    bigNumberLCD._createChar(1, bigNumbersTopBlock);
-                    bigNumberLCD._createChar(2, bigNumbersBottomBlock);
-
                     // Prepare for statistics page here display max first but for half the regular time
                     sCellStatisticsDisplayCounter = (CELL_STATISTICS_COUNTER_MASK >> 1) - 1;
-
-                } else if (tDisplayPageNumber == JK_BMS_PAGE_BIG_INFO) {
-                    bigNumberLCD.begin(); // Creates custom character used for generating big numbers
                 }
                 setDisplayPage(tDisplayPageNumber);
             }
@@ -1507,33 +1753,59 @@ void checkButtonPress() {
 }
 
 #if defined(STANDALONE_TEST)
+/*
+ * Feed the test frame to the receive handler byte by byte, like the ISR does
+ */
+void receiveTestJKReplyStatusFrame() {
+    initJKReplyFrameReceiving();
+    for (uint16_t i = 0; i < sizeof(TestJKReplyStatusFrame); ++i) {
+        handleJKReplyFrameReceivedByte(pgm_read_byte(&TestJKReplyStatusFrame[i]));
+    }
+    if (checkJK_BMSStatusFrame() == JK_BMS_RECEIVE_FINISHED) {
+        useReceivedJKReply();
+    }
+}
+
 void doStandaloneTest() {
 
 #  if defined(LCD_PAGES_TEST)
     if (sSerialLCDAvailable) {
         testLCDPages();
+        myLCD.flush();
         delay(2000);
 #    if defined(BIG_NUMBER_TEST)
         testBigNumbers();
 #    endif
-        memcpy_P(JKReplyFrameBuffer, TestJKReplyStatusFrame, sizeof(TestJKReplyStatusFrame));
+        receiveTestJKReplyStatusFrame();
         processReceivedData(); // to clear every changes
     }
 #  endif
 }
 
+/*
+ * Current which matches the test value of BatteryLoadPower at the current battery voltage
+ */
+void setTestBatteryLoadCurrentFromPower() {
+#if defined(USE_FIXED_POINT)
+    JKComputedData.BatteryLoadCurrent10Milliampere = ((int32_t) JKComputedData.BatteryLoadPower * 10000)
+            / JKComputedData.BatteryVoltage10Millivolt;
+#else
+    JKComputedData.BatteryLoadCurrentFloat = JKComputedData.BatteryLoadPower / JKComputedData.BatteryVoltageFloat;
+#endif
+}
+
 void testLCDPages() {
     sLCDDisplayPageNumber = JK_BMS_PAGE_OVERVIEW;
     printBMSDataOnLCD();
 
     sLCDDisplayPageNumber = JK_BMS_PAGE_CELL_INFO;
-// Create symbols character for maximum and minimum
-    bigNumberLCD._createChar(1, bigNumbersTopBlock);
-    bigNumberLCD._createChar(2, bigNumbersBottomBlock);
+    createCustomCharactersForDisplayPage(JK_BMS_PAGE_CELL_INFO);
+    myLCD.flush();
     delay(2000);
     printBMSDataOnLCD();
 
     sLCDDisplayPageNumber = JK_BMS_PAGE_CAN_INFO;
+    myLCD.flush();
     delay(2000);
     printBMSDataOnLCD();
 
@@ -1542,16 +1814,18 @@ void testLCDPages() {
      */
     sJKFAllReplyPointer->SOCPercent = 100;
     JKComputedData.BatteryLoadPower = -11000;
-    JKComputedData.BatteryLoadCurrentFloat = JKComputedData.BatteryLoadPower / JKComputedData.BatteryVoltageFloat;
-    JKComputedData.TemperaturePowerMosFet = 111;
-    JKComputedData.TemperatureSensor1 = 100;
+    setTestBatteryLoadCurrentFromPower();
+    sJKFAllReplyPointer->TemperaturePowerMosFet = 111;
+    sJKFAllReplyPointer->TemperatureSensor1 = 100;
 
     sLCDDisplayPageNumber = JK_BMS_PAGE_OVERVIEW;
+    myLCD.flush();
     delay(2000);
     printBMSDataOnLCD();
 
     sLCDDisplayPageNumber = JK_BMS_PAGE_BIG_INFO;
-    bigNumberLCD.begin();
+    createCustomCharactersForDisplayPage(JK_BMS_PAGE_BIG_INFO);
+    myLCD.flush();
     delay(2000);
     printBMSDataOnLCD();
 
@@ -1559,31 +1833,38 @@ void testLCDPages() {
      * Test other values
      */
     sJKFAllReplyPointer->AlarmUnion.AlarmBits.PowerMosFetOvertemperatureAlarm = true;
-    JKComputedData.TemperaturePowerMosFet = 90;
-    JKComputedData.TemperatureSensor1 = 25;
+    sJKFAllReplyPointer->TemperaturePowerMosFet = 90;
+    sJKFAllReplyPointer->TemperatureSensor1 = 25;
     handleAndPrintAlarmInfo(); // this sets the LCD alarm string
 
     sJKFAllReplyPointer->SOCPercent = 1;
     JKComputedData.BatteryLoadPower = 12345;
-    JKComputedData.BatteryLoadCurrentFloat = JKComputedData.BatteryLoadPower / JKComputedData.BatteryVoltageFloat;
+    setTestBatteryLoadCurrentFromPower();
 
     sLCDDisplayPageNumber = JK_BMS_PAGE_OVERVIEW;
+    myLCD.flush();
     delay(2000);
     printBMSDataOnLCD();
 
     sLCDDisplayPageNumber = JK_BMS_PAGE_BIG_INFO;
+    myLCD.flush();
     delay(2000);
     printBMSDataOnLCD();
 
     lastJKReply.AlarmUnion.AlarmBits.PowerMosFetOvertemperatureAlarm = true; // to enable reset of LCD alarm string
     sJKFAllReplyPointer->AlarmUnion.AlarmBits.PowerMosFetOvertemperatureAlarm = false;
-    JKComputedData.TemperaturePowerMosFet = 33;
+    sJKFAllReplyPointer->TemperaturePowerMosFet = 33;
     handleAndPrintAlarmInfo(); // this resets the LCD alarm string
 
     sJKFAllReplyPointer->SOCPercent = 100;
+#if defined(USE_FIXED_POINT)
+    JKComputedData.BatteryLoadCurrent10Milliampere = -10000;
+#else
     JKComputedData.BatteryLoadCurrentFloat = -100;
+#endif
 
     sLCDDisplayPageNumber = JK_BMS_PAGE_OVERVIEW;
+    myLCD.flush();
     delay(2000);
     printBMSDataOnLCD();
 }
@@ -1598,25 +1879,27 @@ void testBigNumbers() {
          * test with positive numbers
          */
         JKComputedData.BatteryLoadPower = 12345;
-        JKComputedData.BatteryLoadCurrentFloat = JKComputedData.BatteryLoadPower / JKComputedData.BatteryVoltageFloat;
+        setTestBatteryLoadCurrentFromPower();
 
         for (int i = 0; i < 5; ++i) {
+            myLCD.flush();
             delay(4000);
             printBMSDataOnLCD();
             JKComputedData.BatteryLoadPower /= 10; // 1234 -> 12
-            JKComputedData.BatteryLoadCurrentFloat = JKComputedData.BatteryLoadPower / JKComputedData.BatteryVoltageFloat;
+            setTestBatteryLoadCurrentFromPower();
         }
         /*
          * test with negative numbers
          */
         JKComputedData.BatteryLoadPower = -12345;
-        JKComputedData.BatteryLoadCurrentFloat = JKComputedData.BatteryLoadPower / JKComputedData.BatteryVoltageFloat;
+        setTestBatteryLoadCurrentFromPower();
 
         for (int i = 0; i < 5; ++i) {
+            myLCD.flush();
             delay(4000);
             printBMSDataOnLCD();
             JKComputedData.BatteryLoadPower /= 10; // 1234 -> 12
-            JKComputedData.BatteryLoadCurrentFloat = JKComputedData.BatteryLoadPower / JKComputedData.BatteryVoltageFloat;
+            setTestBatteryLoadCurrentFromPower();
         }
 
         sJKFAllReplyPointer->SOCPercent /= 10;
@@ -1638,6 +1921,7 @@ void handleOvervoltage() {
         myLCD.print(F("VCC overvoltage"));
         myLCD.setCursor(0, 1);
         myLCD.print(F("VCC > 5.25 V"));
+        myLCD.flush();
     }
 #endif
 // Do it as long as overvoltage happens
@@ -1673,33 +1957,119 @@ bool isVCCTooHighSimple() {
 #endif
 
 #if defined(USE_SLEEP)
+/*
+ * Called at the end of each loop.
+ * While a reply is pending or CAN frames are not yet transmitted, sleep in IDLE mode until the next interrupt.
+ * Timer 0 keeps running in IDLE mode, so the millis() interrupt wakes us after at most 1 ms and the USART RX interrupt at the next reply byte.
+ * Power down with a pin change wake up at the start bit of RX is not possible, because the oscillator start up time would lose the first byte.
+ *
+ * Otherwise sleep in PWR_SAVE mode in watchdog steps until the next BMS request or the next scheduled CAN frame is due.
+ * I have seen clock deviation of + 30 % of the watchdog, so we sleep only 3/4 of the time and wait the rest in IDLE mode.
+ * The millis() timer is disabled during sleep, but millis will be incremented by sleepWithWatchdog() function.
+ * The INT0 edge interrupt of the button requires the I/O clock, so the button pin wakes us up by the pin change interrupt.
+ */
 void LoopDelayWithSleep() {
-    Serial.flush();
+    uint32_t tMillisOfDutyCycleMeasurement = millis() - sMillisOfDutyCycleMeasurementStart;
+    if (tMillisOfDutyCycleMeasurement >= MILLISECONDS_FOR_DUTY_CYCLE_MEASUREMENT) {
+        uint16_t tAsleepPermille = sMicrosAsleep / tMillisOfDutyCycleMeasurement; // micros / millis gives per mille
+        if (tAsleepPermille > 1000) {
+            tAsleepPermille = 1000; // The time of a sleep, which was interrupted by the button, is only estimated
+        }
+        sAwakePermille = 1000 - tAsleepPermille;
+        sMillisOfDutyCycleMeasurementStart = millis();
+        sMicrosAsleep = 0;
+    }
 
-    /*
-     * Interrupts, like button press will wake us up early.
-     * The millis() timer is disabled during sleep, but millis will be incremented by sleepWithWatchdog() function.
-     */
-    if (!sPageButtonJustPressed) { // skip next delays if button was pressed after loop button processing, to enable fast response
-#  if defined(TIMING_TEST)
-        digitalWriteFast(TIMING_TEST_PIN, HIGH);
-#  endif
-        sleepWithWatchdog(WDTO_1S, true); // I have seen clock deviation of + 30 % :-(
+    if (sPageButtonJustPressed || PageSwitchButtonAtPin2.readButtonState()) {
+        return; // The button must be handled, and a long press must be detected by the next loops
     }
-    if (!sPageButtonJustPressed) { // skip next delays if button was pressed during sleep, which waked us up, to enable fast response
-#  if defined(TIMING_TEST)
-        digitalWriteFast(TIMING_TEST_PIN, LOW);
-#  endif
-        sleepWithWatchdog(WDTO_500MS, true);
+
+    if (sFrameIsRequested || !isCANTransmitComplete()
+#if defined(USE_SERIAL_LCD)
+            || (sSerialLCDAvailable && !myLCD.isFlushComplete()) // The next loop sends the next characters
+#endif
+#if defined(USE_TWI_TX)
+            || !isTWITXComplete() // The TWI clock is stopped during PWR_SAVE
+#endif
+            ) {
+        sleepIdle();
+        return;
+    }
+
+    int32_t tMillisToSleep = sMillisBetweenJKDataFrameRequests - (millis() - sMillisOfLastRequestedJKDataFrame);
+    uint16_t tMillisUntilNextCANFrame = getMillisUntilNextPylontechCANFrame();
+    if (tMillisToSleep > tMillisUntilNextCANFrame) {
+        tMillisToSleep = tMillisUntilNextCANFrame;
     }
-    if (!sPageButtonJustPressed) { // skip next delay if button was pressed during sleep, which waked us up, to enable fast response
+    tMillisToSleep = (tMillisToSleep / 4) * 3;
+    if (tMillisToSleep < (int32_t) computeSleepMillis(WDTO_15MS)) {
+        sleepIdle();
+        return;
+    }
+
+    Serial.flush(); // The USART requires the I/O clock, which is stopped during PWR_SAVE
 #  if defined(TIMING_TEST)
-        digitalWriteFast(TIMING_TEST_PIN, HIGH);
+    digitalWriteFast(TIMING_TEST_PIN, HIGH);
 #  endif
-        sleepWithWatchdog(WDTO_250MS, true); // assume maximal 250 ms for BMS, LCD and CAN communication
+    sWakeUpByButton = false;
+    PCIFR = _BV(PCIF2);                 // Clear a pin change of the button before the sleep
+    PCMSK2 = _BV(PCINT18);              // PCINT18 is PD2 / INT0
+    PCICR |= _BV(PCIE2);
+    set_sleep_mode(SLEEP_MODE_PWR_SAVE);
+
+    int8_t tWatchdogPrescaler = WDTO_8S;
+    // skip next delays if button was pressed during sleep, which waked us up, to enable fast response
+    while (tWatchdogPrescaler >= WDTO_15MS && !sWakeUpByButton) {
+        uint16_t tSleepMillis = computeSleepMillis(tWatchdogPrescaler);
+        if (tSleepMillis > tMillisToSleep) {
+            tWatchdogPrescaler--; // try next shorter sleep
+        } else {
+            tSleepMillis = sleepWithWatchdog(tWatchdogPrescaler, true); // Returns the estimated time, if the button waked us up
+            sMicrosAsleep += tSleepMillis * 1000UL;
+            tMillisToSleep -= tSleepMillis;
+        }
+    }
+
+    PCICR &= ~_BV(PCIE2);
 #  if defined(TIMING_TEST)
-        digitalWriteFast(TIMING_TEST_PIN, LOW);
+    digitalWriteFast(TIMING_TEST_PIN, LOW);
 #  endif
+    if (sWakeUpByButton) {
+        /*
+         * The INT0 interrupt missed the button change during sleep, so handle it now with the adjusted millis()
+         */
+        noInterrupts();
+        handleINT0Interrupt();
+        interrupts();
     }
 }
+
+/*
+ * Sleep until the next interrupt, which is at least the 1 ms interrupt of timer 0, which keeps millis() running
+ */
+void sleepIdle() {
+    uint32_t tMicrosOfSleepStart = micros();
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_cpu();
+    sMicrosAsleep += micros() - tMicrosOfSleepStart;
+}
+
+/*
+ * Only wakes up the CPU from PWR_SAVE, the button itself is handled after the sleep
+ */
+ISR(PCINT2_vect) {
+    sWakeUpByButton = true;
+    PCICR &= ~_BV(PCIE2); // Only one wake up
+}
+
+/*
+ * Prints the duty cycle of the last complete measurement period, e.g. "Awake 2.4 % of the last 60000 ms"
+ */
+void printSleepDutyCycle() {
+    Serial.print(F("Awake "));
+    Serial.print(sAwakePermille / 10);
+    Serial.print('.');
+    Serial.print(sAwakePermille % 10);
+    Serial.println(F(" % of the last " STR(MILLISECONDS_FOR_DUTY_CYCLE_MEASUREMENT) " ms"));
+}
 #endif
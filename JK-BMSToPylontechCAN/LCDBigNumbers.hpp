@@ -401,11 +401,15 @@ public:
 
     //createChar with PROGMEM input
     void _createChar(uint8_t location, const uint8_t *charmap) {
+#if defined(USE_PARALLEL_LCD)
         location &= 0x7; // we only have 8 locations 0-7
         LCD->command(LCD_SETCGRAMADDR | (location << 3));
         for (int i = 0; i < 8; i++) {
             LCD->write(pgm_read_byte(charmap++));
         }
+#else
+        LCD->createChar(location, (const char*) charmap); // write() of LiquidCrystal_I2C writes only to its shadow buffer
+#endif
     }
 
     /**
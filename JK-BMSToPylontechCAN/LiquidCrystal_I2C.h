@@ -54,6 +54,28 @@
 #define Rw 0b00000010  // Read/Write bit
 #define Rs 0b00000001  // Register select bit
 
+/*
+ * All characters are written to a shadow buffer in RAM and flush() sends only the changed characters to the LCD.
+ * clear() and setCursor() send nothing. After clear(), flush() sets all characters to space, which were not written since clear().
+ * This way, a page can be cleared and completely rewritten, and only its changed characters are sent.
+ */
+#if !defined(LCD_SHADOW_BUFFER_SIZE)
+#define LCD_SHADOW_BUFFER_SIZE  80 // 20 columns x 4 rows
+#endif
+#define LCD_ADDRESS_UNKNOWN     0xFF // DDRAM address of the LCD after commands, which do not set it
+#define LCD_NUMBER_OF_CUSTOM_CHARACTERS 8 // CGRAM locations
+
+/*
+ * sendBuffer() sends the 6 expander bytes of each character (3 for each nibble) in one I2C transaction.
+ * The 32 byte buffer of the Wire library holds 5 characters.
+ */
+#define LCD_EXPANDER_BYTES_PER_CHARACTER    6
+#if defined(BUFFER_LENGTH)
+#define LCD_CHARACTERS_PER_WIRE_TRANSMISSION    (BUFFER_LENGTH / LCD_EXPANDER_BYTES_PER_CHARACTER)
+#else
+#define LCD_CHARACTERS_PER_WIRE_TRANSMISSION    (32 / LCD_EXPANDER_BYTES_PER_CHARACTER)
+#endif
+
 class LiquidCrystal_I2C : public Print {
 public:
   LiquidCrystal_I2C(uint8_t lcd_Addr,uint8_t lcd_cols,uint8_t lcd_rows);
@@ -79,11 +101,18 @@ public:
   void autoscroll();
   void noAutoscroll();
   void createChar(uint8_t, uint8_t[]);
+  /*
+   * createChar() with a PROGMEM charmap remembers the charmap of each CGRAM location and skips the upload,
+   * if the location already contains this charmap. So pages can create their custom characters on each page switch.
+   */
   void createChar(uint8_t location, const char *charmap);
   // Example: 	const char bell[8] PROGMEM = {B00100,B01110,B01110,B01110,B11111,B00000,B00100,B00000};
 
   void setCursor(uint8_t, uint8_t);
   size_t write(uint8_t);
+  void flush();
+  void flush(uint8_t aMaximumNumberOfCharacters);
+  bool isFlushComplete();
   void command(uint8_t);
   void init();
   void oled_init();
@@ -112,6 +141,9 @@ void draw_vertical_graph(uint8_t row, uint8_t column, uint8_t len,  uint8_t pixe
 private:
   void init_priv();
   void send(uint8_t, uint8_t);
+  void sendBuffer(const uint8_t *aBuffer, uint8_t aLength, uint8_t aMode);
+  void streamNibble(uint8_t aNibbleAndMode);
+  void streamByte(uint8_t aData);
   void write4bits(uint8_t);
   void expanderWrite(uint8_t);
   void pulseEnable(uint8_t);
@@ -124,6 +156,14 @@ private:
   uint8_t _cols;
   uint8_t _rows;
   uint8_t _backlightval;
+  uint8_t _shadowBuffer[LCD_SHADOW_BUFFER_SIZE];               // Characters of all rows, starting with row 0
+  uint8_t _shadowBufferChanged[(LCD_SHADOW_BUFFER_SIZE + 7) / 8]; // One bit for each character, which was not yet sent
+  uint8_t _shadowBufferWritten[(LCD_SHADOW_BUFFER_SIZE + 7) / 8]; // One bit for each character, which was written since clear()
+  bool _shadowBufferHasChanges;
+  bool _shadowBufferIsCleared;                                // clear() was called since the last flush()
+  uint8_t _shadowBufferIndex;                                 // Index of the next character to write
+  uint8_t _LCDAddress;                                        // DDRAM address for the next character sent or LCD_ADDRESS_UNKNOWN
+  const char *_customCharacterCharmaps[LCD_NUMBER_OF_CUSTOM_CHARACTERS]; // PROGMEM charmap of each CGRAM location or NULL if unknown
 };
 
 #endif
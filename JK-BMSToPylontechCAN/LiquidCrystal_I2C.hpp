@@ -8,12 +8,102 @@
 
 #include "LiquidCrystal_I2C.h"
 #include <inttypes.h>
-
-inline size_t LiquidCrystal_I2C::write(uint8_t value) {
-    send(value, Rs);
+#include <string.h> // for memset()
+
+const uint8_t LCDRowOffsets[] = { 0x00, 0x40, 0x14, 0x54 };
+
+/*
+ * Writes to the shadow buffer and marks the character as changed, if it differs from the current content
+ */
+size_t LiquidCrystal_I2C::write(uint8_t value) {
+    uint8_t tIndex = _shadowBufferIndex;
+    if (tIndex < LCD_SHADOW_BUFFER_SIZE) {
+        uint8_t tMask = 1 << (tIndex % 8);
+        _shadowBufferWritten[tIndex / 8] |= tMask;
+        if (_shadowBuffer[tIndex] != value) {
+            _shadowBuffer[tIndex] = value;
+            _shadowBufferChanged[tIndex / 8] |= tMask;
+            _shadowBufferHasChanges = true;
+        }
+        _shadowBufferIndex = tIndex + 1;
+    }
     return 1;
 }
 
+/*
+ * Sends all changed characters of the shadow buffer to the LCD.
+ */
+void LiquidCrystal_I2C::flush() {
+    flush(LCD_SHADOW_BUFFER_SIZE);
+}
+
+/*
+ * Sends at most aMaximumNumberOfCharacters changed characters of the shadow buffer to the LCD.
+ * The next call continues with the remaining changed characters, so a page is sent in slices by successive loops.
+ * The cursor of the LCD is only set, if the character does not follow the last one sent.
+ */
+void LiquidCrystal_I2C::flush(uint8_t aMaximumNumberOfCharacters) {
+    if (!_shadowBufferHasChanges || aMaximumNumberOfCharacters == 0) {
+        return;
+    }
+    if (_shadowBufferIsCleared) {
+        _shadowBufferIsCleared = false;
+        for (uint_fast8_t i = 0; i < LCD_SHADOW_BUFFER_SIZE; ++i) {
+            uint8_t tMask = 1 << (i % 8);
+            if (!(_shadowBufferWritten[i / 8] & tMask) && _shadowBuffer[i] != ' ') {
+                _shadowBuffer[i] = ' ';
+                _shadowBufferChanged[i / 8] |= tMask;
+            }
+        }
+    }
+
+    uint8_t tIndex = 0;
+    for (uint_fast8_t tRow = 0; tRow < _rows; ++tRow) {
+        uint_fast8_t tColumn = 0;
+        while (tColumn < _cols && tIndex < LCD_SHADOW_BUFFER_SIZE) {
+            /*
+             * Collect the run of changed characters in this row and send it in one I2C transaction
+             */
+            uint_fast8_t tRunLength = 0;
+            while (tRunLength < aMaximumNumberOfCharacters && tColumn + tRunLength < _cols
+                    && tIndex + tRunLength < LCD_SHADOW_BUFFER_SIZE) {
+                uint8_t tRunIndex = tIndex + tRunLength;
+                uint8_t tMask = 1 << (tRunIndex % 8);
+                if (!(_shadowBufferChanged[tRunIndex / 8] & tMask)) {
+                    break;
+                }
+                _shadowBufferChanged[tRunIndex / 8] &= ~tMask;
+                tRunLength++;
+            }
+            if (tRunLength == 0) {
+                tColumn++;
+                tIndex++;
+            } else {
+                uint8_t tAddress = tColumn + LCDRowOffsets[tRow];
+                if (_LCDAddress != tAddress) {
+                    command(LCD_SETDDRAMADDR | tAddress);
+                }
+                sendBuffer(&_shadowBuffer[tIndex], tRunLength, Rs);
+                _LCDAddress = tAddress + tRunLength;
+                aMaximumNumberOfCharacters -= tRunLength;
+                if (aMaximumNumberOfCharacters == 0) {
+                    return; // _shadowBufferHasChanges is still true, the next call checks for remaining changes
+                }
+                tColumn += tRunLength;
+                tIndex += tRunLength;
+            }
+        }
+    }
+    _shadowBufferHasChanges = false;
+}
+
+/*
+ * Return true if all changed characters are sent to the LCD
+ */
+bool LiquidCrystal_I2C::isFlushComplete() {
+    return !_shadowBufferHasChanges;
+}
+
 #if defined(USE_SOFT_I2C_MASTER)
 //#define USE_SOFT_I2C_MASTER_H_AS_PLAIN_INCLUDE
 #include "SoftI2CMasterConfig.h"    // Include configuration for sources
@@ -22,6 +112,18 @@ inline size_t LiquidCrystal_I2C::write(uint8_t value) {
 #define USE_SOFTWIRE_H_AS_PLAIN_INCLUDE
 #include "SoftWire.h"
 #endif
+#if defined(USE_TWI_TX)
+#include "TWI_TX.hpp"               // Interrupt driven TWI, expanderWrite() does not wait for the transmission
+#endif
+
+/*
+ * The delays required by the LCD must start after the transmission of the command
+ */
+static inline void waitForExpanderWrites() {
+#if defined(USE_TWI_TX)
+    waitForTWITXComplete();
+#endif
+}
 
 // When the display powers up, it is configured as follows:
 //
@@ -60,7 +162,9 @@ void LiquidCrystal_I2C::init() {
 }
 
 void LiquidCrystal_I2C::init_priv() {
-#if defined(USE_SOFT_I2C_MASTER)
+#if defined(USE_TWI_TX)
+    initTWITX(_Addr);
+#elif defined(USE_SOFT_I2C_MASTER)
     i2c_init();
 #else
     Wire.begin();
@@ -87,6 +191,7 @@ void LiquidCrystal_I2C::begin(uint8_t cols __attribute__((unused)), uint8_t line
 
     // Now we pull both RS and R/W low to begin commands
     expanderWrite(_backlightval);	// reset expander and turn backlight off (Bit 8 =1)
+    waitForExpanderWrites();
     delay(1000);
 
     //put the LCD into 4 bit mode
@@ -95,14 +200,17 @@ void LiquidCrystal_I2C::begin(uint8_t cols __attribute__((unused)), uint8_t line
 
     // we start in 8bit mode, try to set 4 bit mode
     write4bits(0x03 << 4);
+    waitForExpanderWrites();
     delayMicroseconds(4500); // wait min 4.1ms
 
     // second try
     write4bits(0x03 << 4);
+    waitForExpanderWrites();
     delayMicroseconds(4500); // wait min 4.1ms
 
     // third go!
     write4bits(0x03 << 4);
+    waitForExpanderWrites();
     delayMicroseconds(150);
 
     // finally, set to 4-bit interface
@@ -116,37 +224,45 @@ void LiquidCrystal_I2C::begin(uint8_t cols __attribute__((unused)), uint8_t line
     display();
 
     // clear it off
-    clear();
+    command(LCD_CLEARDISPLAY); // clear display, set cursor position to zero
+    waitForExpanderWrites();
+    delayMicroseconds(1500);  // this command takes a long time!
+    memset(_shadowBuffer, ' ', sizeof(_shadowBuffer));
+    memset(_shadowBufferChanged, 0, sizeof(_shadowBufferChanged));
+    memset(_customCharacterCharmaps, 0, sizeof(_customCharacterCharmaps)); // CGRAM content is unknown after reset of the Arduino
+    _shadowBufferHasChanges = false;
+    _shadowBufferIsCleared = false;
+    _shadowBufferIndex = 0;
 
     // Initialize to default text direction (for roman languages)
     _displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
 
     // set the entry mode
     command(LCD_ENTRYMODESET | _displaymode);
-
-    home();
-
+    _LCDAddress = 0;
 }
 
 /********** high level commands, for the user! */
+/*
+ * The next flush() clears all characters, which are not written until then.
+ * This avoids the LCD_CLEARDISPLAY command, which takes 1.5 ms and lets the display flicker.
+ */
 void LiquidCrystal_I2C::clear() {
-    command(LCD_CLEARDISPLAY); // clear display, set cursor position to zero
-    delayMicroseconds(1500);  // this command takes a long time! // AJ 20.9.23 1200 is too short for my 2004 LCD's, 1400 is OK
-    if (_oled)
-        setCursor(0, 0);
+    memset(_shadowBufferWritten, 0, sizeof(_shadowBufferWritten));
+    _shadowBufferIsCleared = true;
+    _shadowBufferHasChanges = true;
+    _shadowBufferIndex = 0;
 }
 
 void LiquidCrystal_I2C::home() {
-    command(LCD_RETURNHOME);  // set cursor position to zero
-    delayMicroseconds(2000);  // this command takes a long time!
+    _shadowBufferIndex = 0;
 }
 
 void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
-    int row_offsets[] = { 0x00, 0x40, 0x14, 0x54 };
-    if (row > _numlines) {
+    if (row >= _numlines) {
         row = _numlines - 1;    // we count rows starting w/0
     }
-    command(LCD_SETDDRAMADDR | (col + row_offsets[row]));
+    _shadowBufferIndex = (row * _cols) + col;
 }
 
 // Turn the display on/off (quickly)
@@ -215,19 +331,22 @@ void LiquidCrystal_I2C::noAutoscroll(void) {
 // with custom characters
 void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[]) {
     location &= 0x7; // we only have 8 locations 0-7
+    _customCharacterCharmaps[location] = NULL; // RAM content may change
     command(LCD_SETCGRAMADDR | (location << 3));
-    for (int i = 0; i < 8; i++) {
-        write(charmap[i]);
-    }
+    sendBuffer(charmap, 8, Rs); // Not to the shadow buffer
 }
 
-//createChar with PROGMEM input
+//createChar with PROGMEM input, which is skipped if the location already contains this charmap
 void LiquidCrystal_I2C::createChar(uint8_t location, const char *charmap) {
     location &= 0x7; // we only have 8 locations 0-7
-    command(LCD_SETCGRAMADDR | (location << 3));
-    for (int i = 0; i < 8; i++) {
-        write(pgm_read_byte_near(charmap++));
+    if (_customCharacterCharmaps[location] == charmap) {
+        return;
     }
+    _customCharacterCharmaps[location] = charmap;
+    command(LCD_SETCGRAMADDR | (location << 3));
+    uint8_t tCharmap[8];
+    memcpy_P(tCharmap, charmap, sizeof(tCharmap));
+    sendBuffer(tCharmap, sizeof(tCharmap), Rs); // Not to the shadow buffer
 }
 
 // Turn the (optional) backlight off/on
@@ -244,6 +363,7 @@ void LiquidCrystal_I2C::backlight(void) {
 /*********** mid level commands, for sending data/cmds */
 
 inline void LiquidCrystal_I2C::command(uint8_t value) {
+    _LCDAddress = LCD_ADDRESS_UNKNOWN; // flush() sets it after the command
     send(value, 0);
 }
 
@@ -251,10 +371,55 @@ inline void LiquidCrystal_I2C::command(uint8_t value) {
 
 // write either command or data
 void LiquidCrystal_I2C::send(uint8_t value, uint8_t mode) {
-    uint8_t highnib = value & 0xf0;
-    uint8_t lownib = (value << 4) & 0xf0;
-    write4bits((highnib) | mode);
-    write4bits((lownib) | mode);
+    sendBuffer(&value, 1, mode);
+}
+
+/*
+ * Sends the bytes as data (aMode = Rs) or commands (aMode = 0) with one I2C transaction instead of one for each expander byte.
+ * The transaction of the Wire library is restarted after LCD_CHARACTERS_PER_WIRE_TRANSMISSION bytes, because of its buffer size.
+ * The TWI_TX queue needs no transaction handling, its ISR sends all queued bytes in one transaction.
+ */
+void LiquidCrystal_I2C::sendBuffer(const uint8_t *aBuffer, uint8_t aLength, uint8_t aMode) {
+#if defined(USE_SOFT_I2C_MASTER) && !defined(USE_TWI_TX)
+    i2c_start(_Addr << 1);
+#endif
+    for (uint_fast8_t i = 0; i < aLength; ++i) {
+#if !defined(USE_TWI_TX) && !defined(USE_SOFT_I2C_MASTER)
+        if (i % LCD_CHARACTERS_PER_WIRE_TRANSMISSION == 0) {
+            if (i != 0) {
+                Wire.endTransmission();
+            }
+            Wire.beginTransmission(_Addr);
+        }
+#endif
+        uint8_t tValue = aBuffer[i];
+        streamNibble((tValue & 0xF0) | aMode);
+        streamNibble((tValue << 4) | aMode);
+    }
+#if defined(USE_SOFT_I2C_MASTER) && !defined(USE_TWI_TX)
+    i2c_stop();
+#elif !defined(USE_TWI_TX)
+    Wire.endTransmission();
+#endif
+}
+
+/*
+ * Data setup, enable high, enable low. Same expander bytes as write4bits(), but within the current transaction.
+ */
+void LiquidCrystal_I2C::streamNibble(uint8_t aNibbleAndMode) {
+    streamByte(aNibbleAndMode);
+    streamByte(aNibbleAndMode | En);
+    streamByte(aNibbleAndMode);
+}
+
+void LiquidCrystal_I2C::streamByte(uint8_t aData) {
+#if defined(USE_TWI_TX)
+    TWITXWrite(aData | _backlightval);
+#elif defined(USE_SOFT_I2C_MASTER)
+    i2c_write(aData | _backlightval);
+#else
+    Wire.write((int )(aData) | _backlightval);
+#endif
 }
 
 void LiquidCrystal_I2C::write4bits(uint8_t value) {
@@ -263,7 +428,9 @@ void LiquidCrystal_I2C::write4bits(uint8_t value) {
 }
 
 void LiquidCrystal_I2C::expanderWrite(uint8_t _data) {
-#if defined(USE_SOFT_I2C_MASTER)
+#if defined(USE_TWI_TX)
+    TWITXWrite(_data | _backlightval);
+#elif defined(USE_SOFT_I2C_MASTER)
     i2c_write_byte(_Addr << 1, _data | _backlightval);
 #else
     Wire.beginTransmission(_Addr);
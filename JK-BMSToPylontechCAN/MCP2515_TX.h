@@ -28,5 +28,22 @@
 #include <inttypes.h>
 
 bool initializeCAN(uint32_t aBaudrate, uint8_t aCrystalMHz, Print *aSerial); // Return true if error happens
+#if !defined(MCP2515_TX_QUEUE_SIZE)
+#define MCP2515_TX_QUEUE_SIZE   16 // Must be a power of 2 and larger than the number of frames sent at once
+#endif
 bool sendCANMessage(uint16_t aCANId, uint8_t aLengthOfBuffer, const uint8_t *aSendDataBufferPointer); // Return true if error happens
+bool handleCANTransmitQueue(); // Return true if error happens
+bool isCANTransmitComplete(); // Return true if queue is empty and no TX buffer is pending at the last check
+
+/*
+ * The hardware acceptance filters of the MCP2515 drop all standard frames except the ones with these 2 IDs.
+ * 0x305 is sent by Pylontech compatible inverters as reply to our frames.
+ */
+#if !defined(MCP2515_RX_FILTER_ID_0)
+#define MCP2515_RX_FILTER_ID_0  0x305
+#endif
+#if !defined(MCP2515_RX_FILTER_ID_1)
+#define MCP2515_RX_FILTER_ID_1  MCP2515_RX_FILTER_ID_0
+#endif
+bool receiveCANMessage(uint16_t *aCANId, uint8_t *aLength, uint8_t *aReceiveDataBufferPointer); // Return true if a frame was received
 #endif // _MCP2515_TX_H
@@ -1,7 +1,7 @@
 /*
  * MCP2515_TX.hpp
  *
- * Functions to control send only functions for MCP2515 CAN controller
+ * Functions to control send and filtered receive functions for MCP2515 CAN controller
  *
  *
  *  Copyright (C) 2023  Armin Joachimsmeyer
@@ -84,6 +84,20 @@ void writeMCP2515Register(uint8_t address, uint8_t value) {
     SPI.endTransaction();
 }
 
+/*
+ * Writes the standard ID to the SIDH and SIDL register of a filter or mask. EXIDE is 0, i.e. the filter only accepts standard frames.
+ */
+void writeMCP2515IDRegisters(uint8_t aSIDHAddress, uint16_t aCANId) {
+    SPI.beginTransaction(sSPISettings);
+    digitalWrite(SPI_CS_PIN, LOW);
+    SPI.transfer(0x02);
+    SPI.transfer(aSIDHAddress);
+    SPI.transfer(aCANId >> 3); // SIDH bit 3:10 of ID
+    SPI.transfer(aCANId << 5); // SIDL bit 0:2 of ID
+    digitalWrite(SPI_CS_PIN, HIGH);
+    SPI.endTransaction();
+}
+
 /*
  * return true if error happens
  */
@@ -140,6 +154,22 @@ bool initializeCAN(uint32_t aBaudrate, uint8_t aCrystalMHz, Print *aSerial) { //
          */
     }
 
+    /*
+     * All 11 bits of the standard ID must match one of the filters. The EID bits of the masks stay 0,
+     * otherwise they would be compared with the first 2 data bytes of a standard frame.
+     * RXB0 uses filter 0 and 1, RXB1 uses filter 2 to 5. If RXB0 is full, the frame rolls over to RXB1.
+     */
+    writeMCP2515IDRegisters(MCP_RXM0SIDH, 0x7FF);
+    writeMCP2515IDRegisters(MCP_RXM1SIDH, 0x7FF);
+    writeMCP2515IDRegisters(MCP_RXF0SIDH, MCP2515_RX_FILTER_ID_0);
+    writeMCP2515IDRegisters(MCP_RXF1SIDH, MCP2515_RX_FILTER_ID_1);
+    writeMCP2515IDRegisters(MCP_RXF2SIDH, MCP2515_RX_FILTER_ID_0);
+    writeMCP2515IDRegisters(MCP_RXF3SIDH, MCP2515_RX_FILTER_ID_1);
+    writeMCP2515IDRegisters(MCP_RXF4SIDH, MCP2515_RX_FILTER_ID_0);
+    writeMCP2515IDRegisters(MCP_RXF5SIDH, MCP2515_RX_FILTER_ID_1);
+    writeMCP2515Register(MCP_RXB0CTRL, MCP_RXB_RX_STDEXT | MCP_RXB_BUKT_MASK);
+    writeMCP2515Register(MCP_RXB1CTRL, MCP_RXB_RX_STDEXT);
+
     // Reset Configuration mode
     writeMCP2515Register(MCP_CANCTRL, MCP2515_CAN_CONTROL_REGISTER_CONTENT);
     if (readMCP2515Register(MCP_CANCTRL) != MCP2515_CAN_CONTROL_REGISTER_CONTENT) {
@@ -153,39 +183,188 @@ bool initializeCAN(uint32_t aBaudrate, uint8_t aCrystalMHz, Print *aSerial) { //
 }
 
 /*
- * return true if error happens
+ * Transmit queue for the 3 TX buffers of the MCP2515.
+ * The data is copied into the entry, so the frame is sent with the content it had at the time of sendCANMessage(),
+ * even if the data is modified before the frame is loaded into a TX buffer.
  */
-bool sendCANMessage(uint16_t aCANId, uint8_t aLengthOfBuffer, const uint8_t *aSendDataBufferPointer) {
+struct MCP2515TXQueueEntryStruct {
+    uint16_t CANId;
+    uint8_t Length;
+    uint8_t Data[8];
+};
+MCP2515TXQueueEntryStruct sMCP2515TXQueue[MCP2515_TX_QUEUE_SIZE];
+uint8_t sMCP2515TXQueueHead = 0; // Index of next entry to write
+uint8_t sMCP2515TXQueueTail = 0; // Index of next entry to load into a TX buffer
 
-    /*
-     * We use transmit buffer 0
-     */
-    writeMCP2515Register(MCP_TXB0SIDH, aCANId >> 3); // write bit 3:10 of ID
-    writeMCP2515Register(MCP_TXB0SIDL, aCANId << 5); // write bit 0:2 and flag "no extended"
-    writeMCP2515Register(MCP_TXB0DLC, aLengthOfBuffer);
+#define MCP2515_NUMBER_OF_TX_BUFFERS    3
+uint8_t sMCP2515TXBuffersPending = 0;   // Bit 0 to 2 are set, if TXB0 to TXB2 are loaded and their TXREQ was not yet seen cleared.
+uint8_t sMCP2515TXBufferPriority[MCP2515_NUMBER_OF_TX_BUFFERS];
+/*
+ * The MCP2515 sends the pending buffer with the highest priority first.
+ * To keep the order of the queue, each loaded buffer gets a lower priority than the pending ones.
+ * After 4 loads we must wait until all buffers are sent, then the priority starts at 3 again.
+ */
+#define MCP2515_NUMBER_OF_TX_PRIORITIES 4
+uint8_t sMCP2515TXPrioritiesLeft = MCP2515_NUMBER_OF_TX_PRIORITIES;
 
-    // Fill buffer
-    for (uint_fast8_t i = 0; i < aLengthOfBuffer; i++) {
-        writeMCP2515Register(MCP_TXB0D0 + i, aSendDataBufferPointer[i]);
+uint8_t readMCP2515Status(void) {
+    uint8_t value;
+
+    SPI.beginTransaction(sSPISettings);
+    digitalWrite(SPI_CS_PIN, LOW);
+    SPI.transfer(MCP_READ_STATUS);
+    value = SPI.transfer(0x00);
+    digitalWrite(SPI_CS_PIN, HIGH);
+    SPI.endTransaction();
+
+    return value;
+}
+
+/*
+ * Load ID, DLC and data with one "LOAD TX BUFFER" burst, starting at TXBnSIDH,
+ * and request sending with aPriority by writing TXBnCTRL, because "Request To Send" can not set the priority.
+ */
+void loadAndRequestMCP2515TXBuffer(uint8_t aBufferIndex, MCP2515TXQueueEntryStruct *aEntry, uint8_t aPriority) {
+    SPI.beginTransaction(sSPISettings);
+    digitalWrite(SPI_CS_PIN, LOW);
+    SPI.transfer(MCP_LOAD_TX0 + (aBufferIndex << 1));
+    SPI.transfer(aEntry->CANId >> 3); // TXBnSIDH bit 3:10 of ID
+    SPI.transfer(aEntry->CANId << 5); // TXBnSIDL bit 0:2 and flag "no extended"
+    SPI.transfer(0);                  // TXBnEID8
+    SPI.transfer(0);                  // TXBnEID0
+    SPI.transfer(aEntry->Length);     // TXBnDLC
+    for (uint_fast8_t i = 0; i < aEntry->Length; i++) {
+        SPI.transfer(aEntry->Data[i]);
     }
+    digitalWrite(SPI_CS_PIN, HIGH);
+    SPI.endTransaction();
 
-    writeMCP2515Register(MCP_TXB0CTRL, MCP_TXB_TXREQ_M);
+    writeMCP2515Register(MCP_TXB0CTRL + (aBufferIndex << 4), MCP_TXB_TXREQ_M | aPriority);
+}
 
-    /*
-     * Check for end of transmission, and if an error happened
-     */
-    while (readMCP2515Register(MCP_TXB0CTRL) & MCP_TXB_TXREQ_M) {
-        if (readMCP2515Register(MCP_TXB0CTRL) & (MCP_TXB_TXERR_M | MCP_TXB_MLOA_M | MCP_TXB_ABTF_M)) {
+/*
+ * Must be called in every loop.
+ * Checks the pending TX buffers with one "READ STATUS" instruction and loads the free buffers from the queue.
+ * If the buffer in transmission has an error, e.g. because of a missing receiver, all pending transmissions are aborted.
+ * Does nothing but returning, if queue is empty and no buffer is pending.
+ * return true if error happens
+ */
+bool handleCANTransmitQueue() {
+    bool tErrorHappened = false;
+    if (sMCP2515TXBuffersPending != 0) {
+        uint8_t tStatus = readMCP2515Status(); // TXREQ of TXB0 is bit 2, of TXB1 bit 4 and of TXB2 bit 6
+        uint8_t tBufferInTransmission = 0;
+        uint8_t tPriorityOfBufferInTransmission = 0;
+        for (uint_fast8_t i = 0; i < MCP2515_NUMBER_OF_TX_BUFFERS; i++) {
+            if (sMCP2515TXBuffersPending & (1 << i)) {
+                if (!(tStatus & (0x04 << (i << 1)))) {
+                    sMCP2515TXBuffersPending &= ~(1 << i); // Sent
+                } else if (sMCP2515TXBufferPriority[i] >= tPriorityOfBufferInTransmission) {
+                    tBufferInTransmission = i;
+                    tPriorityOfBufferInTransmission = sMCP2515TXBufferPriority[i];
+                }
+            }
+        }
+
+        if (sMCP2515TXBuffersPending != 0
+                && (readMCP2515Register(MCP_TXB0CTRL + (tBufferInTransmission << 4))
+                        & (MCP_TXB_TXERR_M | MCP_TXB_MLOA_M | MCP_TXB_ABTF_M))) {
             /*
-             * Error happened here, abort transfer. First retransmit is still pending!
+             * Error happened here, abort all pending transmissions. First retransmit is still pending!
              */
             writeMCP2515Register(MCP_CANCTRL, ABORT_TX | MCP2515_CAN_CONTROL_REGISTER_CONTENT); // Set "Abort All Pending Transmissions" bit
             delayMicroseconds(10);
             writeMCP2515Register(MCP_CANCTRL, MCP2515_CAN_CONTROL_REGISTER_CONTENT); // Reset "Abort All Pending Transmissions" bit
-            return true; // Error
+            sMCP2515TXBuffersPending = 0;
+            tErrorHappened = true;
+        }
+        if (sMCP2515TXBuffersPending == 0) {
+            sMCP2515TXPrioritiesLeft = MCP2515_NUMBER_OF_TX_PRIORITIES;
         }
     }
 
+    /*
+     * Load free buffers as long as we have a priority lower than the pending ones
+     */
+    for (uint_fast8_t i = 0;
+            i < MCP2515_NUMBER_OF_TX_BUFFERS && sMCP2515TXQueueTail != sMCP2515TXQueueHead && sMCP2515TXPrioritiesLeft > 0; i++) {
+        if (!(sMCP2515TXBuffersPending & (1 << i))) {
+            sMCP2515TXPrioritiesLeft--;
+            loadAndRequestMCP2515TXBuffer(i, &sMCP2515TXQueue[sMCP2515TXQueueTail], sMCP2515TXPrioritiesLeft);
+            sMCP2515TXQueueTail = (sMCP2515TXQueueTail + 1) % MCP2515_TX_QUEUE_SIZE;
+            sMCP2515TXBufferPriority[i] = sMCP2515TXPrioritiesLeft;
+            sMCP2515TXBuffersPending |= (1 << i);
+        }
+    }
+    return tErrorHappened;
+}
+
+/*
+ * The state of the TX buffers is updated by handleCANTransmitQueue()
+ */
+bool isCANTransmitComplete() {
+    return sMCP2515TXQueueTail == sMCP2515TXQueueHead && sMCP2515TXBuffersPending == 0;
+}
+
+/*
+ * Appends the frame to the transmit queue and loads it into a free TX buffer. Does not wait for the end of the transmission.
+ * The data at aSendDataBufferPointer is copied into the queue, so it can be modified directly after the call.
+ * return true if error happens, i.e. the queue is full
+ */
+bool sendCANMessage(uint16_t aCANId, uint8_t aLengthOfBuffer, const uint8_t *aSendDataBufferPointer) {
+    uint8_t tNextHead = (sMCP2515TXQueueHead + 1) % MCP2515_TX_QUEUE_SIZE;
+    if (tNextHead == sMCP2515TXQueueTail) {
+        return true; // Queue is full
+    }
+    MCP2515TXQueueEntryStruct *tEntry = &sMCP2515TXQueue[sMCP2515TXQueueHead];
+    tEntry->CANId = aCANId;
+    if (aLengthOfBuffer > 8) {
+        aLengthOfBuffer = 8; // CAN frames have at most 8 data bytes
+    }
+    tEntry->Length = aLengthOfBuffer;
+    memcpy(tEntry->Data, aSendDataBufferPointer, aLengthOfBuffer);
+    sMCP2515TXQueueHead = tNextHead;
+
+    handleCANTransmitQueue();
     return false;
 }
+
+/*
+ * Reads one frame accepted by the filters with one "READ STATUS" and one "READ RX BUFFER" burst.
+ * RXB0 is read first, because it receives first. The RXnIF flag is cleared by the MCP2515 at the end of the burst.
+ * aReceiveDataBufferPointer must have space for 8 bytes.
+ * return true if a frame was received
+ */
+bool receiveCANMessage(uint16_t *aCANId, uint8_t *aLength, uint8_t *aReceiveDataBufferPointer) {
+    uint8_t tStatus = readMCP2515Status(); // RX0IF is bit 0, RX1IF is bit 1
+    uint8_t tInstruction;
+    if (tStatus & MCP_STAT_RX0IF) {
+        tInstruction = MCP_READ_RX0;
+    } else if (tStatus & MCP_STAT_RX1IF) {
+        tInstruction = MCP_READ_RX1;
+    } else {
+        return false;
+    }
+
+    SPI.beginTransaction(sSPISettings);
+    digitalWrite(SPI_CS_PIN, LOW);
+    SPI.transfer(tInstruction);
+    uint16_t tCANId = SPI.transfer(0x00) << 3; // RXBnSIDH
+    tCANId |= SPI.transfer(0x00) >> 5;         // RXBnSIDL
+    SPI.transfer(0x00);                        // RXBnEID8
+    SPI.transfer(0x00);                        // RXBnEID0
+    uint8_t tLength = SPI.transfer(0x00) & 0x0F;
+    if (tLength > 8) {
+        tLength = 8;
+    }
+    for (uint_fast8_t i = 0; i < tLength; i++) {
+        aReceiveDataBufferPointer[i] = SPI.transfer(0x00);
+    }
+    digitalWrite(SPI_CS_PIN, HIGH);
+    SPI.endTransaction();
+
+    *aCANId = tCANId;
+    *aLength = tLength;
+    return true;
+}
 #endif // _MCP2515_TX_HPP
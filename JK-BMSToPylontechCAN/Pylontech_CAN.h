@@ -77,58 +77,118 @@ void fillPylontechCANBatteryRequesFrame(struct JKReplyStruct *aJKFAllReply);
 void fillPylontechCANErrors_WarningsFrame(struct JKReplyStruct *aJKFAllReply);
 void fillPylontechCANCurrentValuesFrame(struct JKReplyStruct *aJKFAllReply);
 
+void fillAllStaticCANData(struct JKReplyStruct *aJKFAllReply);
 void fillAllCANData(struct JKReplyStruct *aJKFAllReply);
 void sendPylontechAllCANFrames(bool aDebugModeActive);
+
+/*
+ * Change detection for new BMS data. Frames 0x351, 0x359 and 0x35C are sent immediately on every change,
+ * 0x355 and 0x356 only if SOC, voltage or current changed by at least their deadband. Otherwise frames are sent by the schedule.
+ */
+#if !defined(CAN_VOLTAGE_DEADBAND_10_MILLIVOLT)
+#define CAN_VOLTAGE_DEADBAND_10_MILLIVOLT       10 // 100 mV
+#endif
+#if !defined(CAN_CURRENT_DEADBAND_100_MILLIAMPERE)
+#define CAN_CURRENT_DEADBAND_100_MILLIAMPERE    10 // 1 A
+#endif
+#if !defined(CAN_SOC_DEADBAND_PERCENT)
+#define CAN_SOC_DEADBAND_PERCENT                1
+#endif
+bool schedulePylontechChangedCANFrames(); // Return true if a frame changed
+
+/*
+ * Schedule of the periodically sent frames. The offset spreads frames of the same period over time to avoid bursts on the CAN bus.
+ * Periods must be below 32768 ms, because the schedule uses the lower 16 bit of millis().
+ */
+#if !defined(MILLISECONDS_BETWEEN_CAN_FRAME_SEND)
+#define MILLISECONDS_BETWEEN_CAN_FRAME_SEND     4000 // Period of status frames 0x359, 0x35C, 0x351, 0x355 and 0x305
+#endif
+#define PYLON_CAN_DYNAMIC_FRAME_PERIOD_MILLIS   (MILLISECONDS_BETWEEN_CAN_FRAME_SEND / 4) // 0x356 voltage, current and temperature
+#define PYLON_CAN_STATIC_FRAME_PERIOD_MILLIS    (MILLISECONDS_BETWEEN_CAN_FRAME_SEND * 5) // 0x35E manufacturer and 0x35F specifications
+#if PYLON_CAN_STATIC_FRAME_PERIOD_MILLIS > 32767
+#error "MILLISECONDS_BETWEEN_CAN_FRAME_SEND * 5 must be below 32768"
+#endif
+struct PylontechCANScheduleEntryStruct {
+    uint16_t CANId;
+    uint8_t FrameLength;
+    void *FrameDataPointer; // Pointer to the FrameData member of a Pylontech*FrameStruct
+    uint16_t PeriodMillis;
+    uint16_t OffsetMillis;
+};
+/*
+ * Generates the schedule entry of a frame at compile time and checks the payload size against the declared DLC
+ */
+template<typename FrameStruct>
+constexpr PylontechCANScheduleEntryStruct PylontechCANScheduleEntry(FrameStruct &aFrame, uint16_t aPeriodMillis,
+        uint16_t aOffsetMillis) {
+    static_assert(FrameStruct::FrameLength <= 8, "CAN frames can have at most 8 data bytes");
+    static_assert(sizeof(FrameStruct::FrameData) >= FrameStruct::FrameLength, "FrameData is smaller than FrameLength");
+    static_assert(sizeof(FrameStruct::FrameData) <= 8, "FrameData is bigger than a CAN frame");
+    return {FrameStruct::CANId, FrameStruct::FrameLength, &aFrame.FrameData, aPeriodMillis, aOffsetMillis};
+}
+extern bool sPylontechCANScheduleIsStarted;
+bool handlePylontechCANSchedule(bool aDebugModeActive);
+uint16_t getMillisUntilNextPylontechCANFrame();
 void modifyAllCanDataToInactive();
 
+/*
+ * Frames of the inverter, which pass the hardware filters of the MCP2515
+ */
+#define MILLISECONDS_BETWEEN_CAN_RECEIVE_CHECKS     10   // Resolution of the measured inverter reply time
+#define INVERTER_TIMEOUT_MILLIS                     5000 // Inverter is assumed to be absent, if no frame was received for this time
+extern bool sInverterIsAlive;
+extern uint16_t sInverterReplyMillis;
+extern uint16_t sNumberOfInverterCANFrames;
+bool handleInverterCANFrames(uint32_t aMillisOfLastCANFrameSent); // Return true if an inverter frame was received
+
 // added by Ngoc
 // checking limit for charging and apply charging control
 uint8_t ReachChargeLimit();
 void ControlChargeScheme();
 void resetCharge();
 
-struct PylontechCANFrameInfoStruct {
-    // Both values will be statically initialized in each instance
-    uint16_t CANId;
-    uint8_t FrameLength;
-};
-
-struct PylontechCANFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo;
-    LongLongUnion FrameData; // 8 byte
-};
-
+/*
+ * Each frame struct declares its CAN ID and its DLC as static constexpr members and contains the payload as FrameData member.
+ * The send and print table PylontechCANSchedule[] is generated from these values at compile time by PylontechCANScheduleEntry().
+ */
 struct PylontechCANAliveFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_NETWORK_ALIVE_MSG_FRAME_ID, 8 }; // 0x305
+    static constexpr uint16_t CANId = PYLON_CAN_NETWORK_ALIVE_MSG_FRAME_ID; // 0x305
+    static constexpr uint8_t FrameLength = 8;
     struct {
         uint8_t AlivePacketArray[8] = { 33 };
     } FrameData;
 };
 
 struct PylontechCANBatteryLimitsFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_LIMITS_FRAME_ID, 8 }; // 0x351
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_LIMITS_FRAME_ID; // 0x351
+    static constexpr uint8_t FrameLength = 8;
     struct {
         int16_t BatteryChargeOvervoltage100Millivolt;       // 0 to 750
         int16_t BatteryChargeCurrentLimit100Milliampere;    // 0 to 5000
         int16_t BatteryDischargeCurrentLimit100Milliampere; // -5000 to 0
         int16_t BatteryDischarge100Millivolt;               // 0 to 65535 // not in documentation
     } FrameData;
+    /*
+     * Only the charge current limit is modified by the charge scheme, all other values are static BMS configuration
+     */
     void fillFrame(struct JKReplyStruct *aJKFAllReply) {
-        FrameData.BatteryChargeOvervoltage100Millivolt = JKComputedData.BatteryFullVoltage10Millivolt / 10;
-        FrameData.BatteryChargeOvervoltage100Millivolt = JKComputedData.BatteryFullVoltage10Millivolt / 10;
+        FrameData.BatteryChargeOvervoltage100Millivolt = aJKFAllReply->BatteryOvervoltageProtection10Millivolt / 10;
+        FrameData.BatteryDischargeCurrentLimit100Milliampere = aJKFAllReply->DischargeOvercurrentProtectionAmpere * 10;
+        FrameData.BatteryDischarge100Millivolt = aJKFAllReply->BatteryUndervoltageProtection10Millivolt / 10;
+    }
+    void fillChargeCurrentLimit(struct JKReplyStruct *aJKFAllReply) {
         if (Charge_Current_100_milliAmp > 0){
           FrameData.BatteryChargeCurrentLimit100Milliampere = Charge_Current_100_milliAmp;
         }else {
-          FrameData.BatteryChargeCurrentLimit100Milliampere = swap(aJKFAllReply->ChargeOvercurrentProtectionAmpere) * 10;
+          FrameData.BatteryChargeCurrentLimit100Milliampere = aJKFAllReply->ChargeOvercurrentProtectionAmpere * 10;
         }
-        //FrameData.BatteryChargeCurrentLimit100Milliampere = swap(aJKFAllReply->ChargeOvercurrentProtectionAmpere) * 10;
-        FrameData.BatteryDischargeCurrentLimit100Milliampere = swap(aJKFAllReply->DischargeOvercurrentProtectionAmpere) * 10;
-        FrameData.BatteryDischarge100Millivolt = swap(aJKFAllReply->BatteryUndervoltageProtection10Millivolt) / 10;
+        //FrameData.BatteryChargeCurrentLimit100Milliampere = aJKFAllReply->ChargeOvercurrentProtectionAmpere * 10;
     }
 };
 
 struct PylontechCANSohSocFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_SOC_SOH_FRAME_ID, 4 }; // 0x355
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_SOC_SOH_FRAME_ID; // 0x355
+    static constexpr uint8_t FrameLength = 4;
     struct {
         uint16_t SOCPercent;
         uint16_t SOHPercent = 100; // fixed 100
@@ -138,9 +198,9 @@ struct PylontechCANSohSocFrameStruct {
     } FrameData;
     void fillFrame(struct JKReplyStruct *aJKFAllReply) {
         //FrameData.SOCPercent = JKComputedData.SOCPercent; //Temporary taken out for testing with real SOC        
-        if (JKComputedData.BatteryType == 0) {
+        if (aJKFAllReply->BatteryType == 0) {
           FrameData.SOHPercent = round(((JKComputedData.Cycles/MAX_CYCLES_LFP)-1)*-100);
-        }else if (JKComputedData.BatteryType == 1) {
+        }else if (aJKFAllReply->BatteryType == 1) {
           FrameData.SOHPercent = round(((JKComputedData.Cycles/MAX_CYCLES_LF)-1)*-100);
         }
         FrameData.SOHPercent = JKComputedData.Cycles; 
@@ -148,22 +208,23 @@ struct PylontechCANSohSocFrameStruct {
 };
 
 struct PylontechCANCurrentValuesFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_CURRENT_VALUES_U_I_T_FRAME_ID, 6 }; // 0x356
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_CURRENT_VALUES_U_I_T_FRAME_ID; // 0x356
+    static constexpr uint8_t FrameLength = 6;
     struct {
         int16_t Voltage10Millivolt;        // 0 to 32767
         int16_t Current100Milliampere;      // -2500 to 2500
         int16_t Temperature100Millicelsius; // -500 to 750
     } FrameData;
     void fillFrame(struct JKReplyStruct *aJKFAllReply) {
-        (void) aJKFAllReply; // To avoid [-Wunused-parameter] warning
-        FrameData.Voltage10Millivolt = JKComputedData.BatteryVoltage10Millivolt;
-        FrameData.Current100Milliampere = JKComputedData.Battery10MilliAmpere / 10;
+        FrameData.Voltage10Millivolt = aJKFAllReply->Battery10Millivolt;
+        FrameData.Current100Milliampere = aJKFAllReply->Battery10MilliAmpere / 10;
         FrameData.Temperature100Millicelsius = JKComputedData.TemperatureMaximum * 10;
     }
 };
 
 struct PylontechCANErrorsWarningsFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_ERROR_WARNINGS_FRAME_ID, 7 }; // 0x359
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_ERROR_WARNINGS_FRAME_ID; // 0x359
+    static constexpr uint8_t FrameLength = 7;
     struct FrameDataStruct {
         // 0=off 1=on
         // Byte 0
@@ -257,7 +318,8 @@ struct PylontechCANErrorsWarningsFrameStruct {
  * 2 bytes
  */
 struct PylontechCANBatteryRequesFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_CHARGE_REQUEST_FRAME_ID, 2 }; // 0x35C
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_CHARGE_REQUEST_FRAME_ID; // 0x35C
+    static constexpr uint8_t FrameLength = 2;
     struct {
         bool :3; // unused
         // 0=off 1=Request
@@ -286,7 +348,7 @@ struct PylontechCANBatteryRequesFrameStruct {
             FrameData.ForceChargeRequestI = 0;
         }
         // If battery drops below lower voltage. See https://powerforum.co.za/topic/13587-battery-anomaly-on-synsynk-hybrid-inverter/
-        if (swap(aJKFAllReply->Battery10Millivolt) < swap(aJKFAllReply->BatteryUndervoltageProtection10Millivolt)) {
+        if (aJKFAllReply->Battery10Millivolt < aJKFAllReply->BatteryUndervoltageProtection10Millivolt) {
             FrameData.ForceChargeRequestII = 1;
         } else {
             FrameData.ForceChargeRequestII = 0;
@@ -300,14 +362,16 @@ struct PylontechCANBatteryRequesFrameStruct {
  * Character array DIYPYLON is not recognized by Deye, array PYLONDIY is recognized as PYLON
  */
 struct PylontechCANManufacturerFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_MANUFACTURER_FRAME_ID, 8 }; // 0x35E
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_MANUFACTURER_FRAME_ID; // 0x35E
+    static constexpr uint8_t FrameLength = 8;
     struct {
         char ManufacturerName[8] = { 'P', 'Y', 'L', 'O', 'N', ' ', ' ', ' ' };
     } FrameData;
 };
 // 0x35F should be removed as it would not work with Luxpower or goodwe, i replaced with 0x373 as placed below
 struct PylontechCANSpecificationsFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_SPECIFICATIONS_FRAME_ID, 8 }; // 0x35F
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_SPECIFICATIONS_FRAME_ID; // 0x35F
+    static constexpr uint8_t FrameLength = 8;
     struct {
         uint16_t CellChemistry;             // 0
         uint8_t HardwareVersionLowByte;     // "0.9"
@@ -317,13 +381,12 @@ struct PylontechCANSpecificationsFrameStruct {
         uint8_t SoftwareVersionHighByte;    // "0.9"
     } FrameData;
     void fillFrame(struct JKReplyStruct *aJKFAllReply) {
-        (void) aJKFAllReply; // To avoid [-Wunused-parameter] warning
         FrameData.CellChemistry = 0;
         FrameData.HardwareVersionLowByte = 0;
         FrameData.HardwareVersionHighByte = 1;
         FrameData.SoftwareVersionLowByte = aJKFAllReply->SoftwareVersionNumber[1];
         FrameData.SoftwareVersionHighByte = aJKFAllReply->SoftwareVersionNumber[0];
-        FrameData.CapacityAmpereHour = JKComputedData.TotalCapacityAmpereHour;
+        FrameData.CapacityAmpereHour = aJKFAllReply->TotalCapacityAmpereHour;
     }
 };
 
@@ -333,15 +396,15 @@ struct PylontechCANSpecificationsFrameStruct {
  * Description was found in a discussion under this fork from Peter: https://github.com/Uksa007/esphome-jk-bms-can/blob/deprecated/esp32-example-can.yaml
  */
 struct PylontechCANLuxpowerCapacityFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_LUXPOWER_CAPACITY_FRAME_ID, 8 }; // 0x379
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_LUXPOWER_CAPACITY_FRAME_ID; // 0x379
+    static constexpr uint8_t FrameLength = 8;
     struct {
         uint16_t CapacityAmpereHour;
         uint16_t Unknown1;
         uint32_t Unknown2;
     } FrameData;
     void fillFrame(struct JKReplyStruct *aJKFAllReply) {
-        (void) aJKFAllReply; // To avoid [-Wunused-parameter] warning
-        FrameData.CapacityAmpereHour = JKComputedData.TotalCapacityAmpereHour;
+        FrameData.CapacityAmpereHour = aJKFAllReply->TotalCapacityAmpereHour;
     }
 };
 
@@ -352,7 +415,8 @@ struct PylontechCANLuxpowerCapacityFrameStruct {
  * 25112023: recorded
  */
 struct PylontechCANCellInfoFrameStruct {
-    struct PylontechCANFrameInfoStruct PylontechCANFrameInfo = { PYLON_CAN_BATTERY_CELL_INFO_FRAME_ID, 8 }; // 0x373
+    static constexpr uint16_t CANId = PYLON_CAN_BATTERY_CELL_INFO_FRAME_ID; // 0x373
+    static constexpr uint8_t FrameLength = 8;
     struct {
         uint16_t CellVoltageMinimumMilliVolt;
         uint16_t CellVoltageMaximumMilliVolt;        
@@ -50,20 +50,29 @@ struct PylontechCANSpecificationsFrameStruct PylontechCANSpecificationsFrame;
 // Frames with fixed data
 struct PylontechCANManufacturerFrameStruct PylontechCANManufacturerFrame;
 struct PylontechCANAliveFrameStruct PylontechCANAliveFrame;
+#if defined(LUXPOWER_EXTENSIONS)
+struct PylontechCANLuxpowerCapacityFrameStruct PylontechCANLuxpowerCapacityFrame;
+struct PylontechCANCellInfoFrameStruct PylontechCANCellInfoFrame;
+#endif
 
-void fillAllCANData(struct JKReplyStruct *aJKFAllReply) {
+/*
+ * Fills the frames or parts of frames, which depend only on the BMS configuration.
+ * Must be called only for the first frame and if checkJKStaticDataChange() detected a change.
+ */
+void fillAllStaticCANData(struct JKReplyStruct *aJKFAllReply) {
     PylontechCANBatteryLimitsFrame.fillFrame(aJKFAllReply);
+    PylontechCANSpecificationsFrame.fillFrame(aJKFAllReply);
+}
+
+void fillAllCANData(struct JKReplyStruct *aJKFAllReply) {
+    PylontechCANBatteryLimitsFrame.fillChargeCurrentLimit(aJKFAllReply);
     PylontechCANSohSocFrame.fillFrame(aJKFAllReply);
     PylontechCANBatteryRequestFrame.fillFrame(aJKFAllReply);
     PylontechCANErrorsWarningsFrame.fillFrame(aJKFAllReply);
     PylontechCANCurrentValuesFrame.fillFrame(aJKFAllReply);
-    PylontechCANSpecificationsFrame.fillFrame(aJKFAllReply);
+    ControlChargeScheme(); // modify charge scheme, before changes are detected
 }
 
-void sendPylontechCANFrame(struct PylontechCANFrameStruct *aPylontechCANFrame) {
-    sendCANMessage(aPylontechCANFrame->PylontechCANFrameInfo.CANId, aPylontechCANFrame->PylontechCANFrameInfo.FrameLength,
-            aPylontechCANFrame->FrameData.UBytes);
-}
 
 /*
  * Called in case of BMS communication timeout
@@ -71,75 +80,283 @@ void sendPylontechCANFrame(struct PylontechCANFrameStruct *aPylontechCANFrame) {
 void modifyAllCanDataToInactive() {
     PylontechCANCurrentValuesFrame.FrameData.Current100Milliampere = 0;
     // Clear all requests in case of timeout / BMS switched off, before sending
-    reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatteryRequestFrame)->FrameData.UWords[0] = 0;
-    reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANErrorsWarningsFrame)->FrameData.ULong.LowLong = 0;
+    PylontechCANBatteryRequestFrame.FrameData.FullChargeRequest = 0;
+    PylontechCANBatteryRequestFrame.FrameData.ForceChargeRequestII = 0;
+    PylontechCANBatteryRequestFrame.FrameData.ForceChargeRequestI = 0;
+    PylontechCANBatteryRequestFrame.FrameData.DischargeEnable = 0;
+    PylontechCANBatteryRequestFrame.FrameData.ChargeEnable = 0;
+    memset(reinterpret_cast<uint8_t*>(&PylontechCANErrorsWarningsFrame.FrameData), 0, 4); // The 4 bytes of errors and warnings
 }
 
-void printPylontechCANFrame(struct PylontechCANFrameStruct *aPylontechCANFrame) {
+/*
+ * Values of the last sent frames for change detection
+ */
+uint8_t sLastSentBatteryLimitsData[8];      // 0x351
+uint8_t sLastSentErrorsWarningsData[8];     // 0x359
+uint8_t sLastSentBatteryRequestData[8];     // 0x35C
+int16_t sLastSentVoltage10Millivolt;        // 0x356
+int16_t sLastSentCurrent100Milliampere;     // 0x356
+uint16_t sLastSentSOCPercent;               // 0x355
+
+void storePylontechSentCANData(uint16_t aCANId, uint8_t aFrameLength, uint8_t *aFrameData) {
+    switch (aCANId) {
+    case PYLON_CAN_BATTERY_LIMITS_FRAME_ID:
+        memcpy(sLastSentBatteryLimitsData, aFrameData, aFrameLength);
+        break;
+    case PYLON_CAN_BATTERY_ERROR_WARNINGS_FRAME_ID:
+        memcpy(sLastSentErrorsWarningsData, aFrameData, aFrameLength);
+        break;
+    case PYLON_CAN_BATTERY_CHARGE_REQUEST_FRAME_ID:
+        memcpy(sLastSentBatteryRequestData, aFrameData, aFrameLength);
+        break;
+    case PYLON_CAN_BATTERY_CURRENT_VALUES_U_I_T_FRAME_ID:
+        sLastSentVoltage10Millivolt = PylontechCANCurrentValuesFrame.FrameData.Voltage10Millivolt;
+        sLastSentCurrent100Milliampere = PylontechCANCurrentValuesFrame.FrameData.Current100Milliampere;
+        break;
+    case PYLON_CAN_BATTERY_SOC_SOH_FRAME_ID:
+        sLastSentSOCPercent = PylontechCANSohSocFrame.FrameData.SOCPercent;
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * Frames with the same due time are sent in the order of this table, alarms and requests first.
+ * Adding a frame requires only its struct with CANId, FrameLength and FrameData and one line in this table.
+ */
+const struct PylontechCANScheduleEntryStruct PylontechCANSchedule[] PROGMEM = {
+        PylontechCANScheduleEntry(PylontechCANErrorsWarningsFrame, MILLISECONDS_BETWEEN_CAN_FRAME_SEND, 0),
+        PylontechCANScheduleEntry(PylontechCANBatteryRequestFrame, MILLISECONDS_BETWEEN_CAN_FRAME_SEND,
+                MILLISECONDS_BETWEEN_CAN_FRAME_SEND / 5),
+        PylontechCANScheduleEntry(PylontechCANBatteryLimitsFrame, MILLISECONDS_BETWEEN_CAN_FRAME_SEND,
+                (MILLISECONDS_BETWEEN_CAN_FRAME_SEND * 2) / 5),
+        PylontechCANScheduleEntry(PylontechCANSohSocFrame, MILLISECONDS_BETWEEN_CAN_FRAME_SEND,
+                (MILLISECONDS_BETWEEN_CAN_FRAME_SEND * 3) / 5),
+        PylontechCANScheduleEntry(PylontechCANAliveFrame, MILLISECONDS_BETWEEN_CAN_FRAME_SEND,
+                (MILLISECONDS_BETWEEN_CAN_FRAME_SEND * 4) / 5),
+        PylontechCANScheduleEntry(PylontechCANCurrentValuesFrame, PYLON_CAN_DYNAMIC_FRAME_PERIOD_MILLIS,
+                PYLON_CAN_DYNAMIC_FRAME_PERIOD_MILLIS / 2),
+        PylontechCANScheduleEntry(PylontechCANManufacturerFrame, PYLON_CAN_STATIC_FRAME_PERIOD_MILLIS,
+                MILLISECONDS_BETWEEN_CAN_FRAME_SEND / 10),
+#if defined(SMA_EXTENSIONS)
+        PylontechCANScheduleEntry(PylontechCANSpecificationsFrame, PYLON_CAN_STATIC_FRAME_PERIOD_MILLIS,
+                MILLISECONDS_BETWEEN_CAN_FRAME_SEND / 2),
+#endif
+#if defined(LUXPOWER_EXTENSIONS)
+        PylontechCANScheduleEntry(PylontechCANLuxpowerCapacityFrame, PYLON_CAN_STATIC_FRAME_PERIOD_MILLIS,
+                (MILLISECONDS_BETWEEN_CAN_FRAME_SEND * 7) / 10),
+        PylontechCANScheduleEntry(PylontechCANCellInfoFrame, PYLON_CAN_STATIC_FRAME_PERIOD_MILLIS,
+                (MILLISECONDS_BETWEEN_CAN_FRAME_SEND * 9) / 10),
+#endif
+        };
+#define PYLON_CAN_NUMBER_OF_SCHEDULED_FRAMES    (sizeof(PylontechCANSchedule) / sizeof(PylontechCANSchedule[0]))
+uint16_t sPylontechCANNextSendMillis[PYLON_CAN_NUMBER_OF_SCHEDULED_FRAMES]; // Lower 16 bit of millis()
+bool sPylontechCANScheduleIsStarted = false; // Set to false, if frames must not be sent. Schedule is then restarted with the offsets.
+
+void printPylontechCANFrame(uint16_t aCANId, uint8_t aFrameLength, uint8_t *aFrameData) {
     Serial.print(F("CANId=0x"));
-    Serial.print(aPylontechCANFrame->PylontechCANFrameInfo.CANId, HEX);
+    Serial.print(aCANId, HEX);
     Serial.print(F(", FrameLength="));
-    Serial.print(aPylontechCANFrame->PylontechCANFrameInfo.FrameLength);
+    Serial.print(aFrameLength);
     Serial.print(F(", Data=0x"));
-    for (uint_fast8_t i = 0; i < aPylontechCANFrame->PylontechCANFrameInfo.FrameLength; ++i) {
+    for (uint_fast8_t i = 0; i < aFrameLength; ++i) {
         if (i != 0) {
             Serial.print(F(", 0x"));
         }
-        Serial.print(aPylontechCANFrame->FrameData.UBytes[i], HEX);
+        Serial.print(aFrameData[i], HEX);
     }
     Serial.println();
 }
 
+/*
+ * Sends the frame of the schedule entry with index aScheduleIndex and prints it if aDebugModeActive is true.
+ * The frame is only printed and its data is only stored for change detection, if the frame could be appended to the transmit queue.
+ * return true if error happens, i.e. the transmit queue is full
+ */
+bool sendPylontechCANFrame(uint_fast8_t aScheduleIndex, bool aDebugModeActive) {
+    uint16_t tCANId = pgm_read_word(&PylontechCANSchedule[aScheduleIndex].CANId);
+    uint8_t tFrameLength = pgm_read_byte(&PylontechCANSchedule[aScheduleIndex].FrameLength);
+    uint8_t *tFrameData = (uint8_t*) pgm_read_word(&PylontechCANSchedule[aScheduleIndex].FrameDataPointer);
+    if (sendCANMessage(tCANId, tFrameLength, tFrameData)) {
+        return true;
+    }
+    if (aDebugModeActive) {
+        printPylontechCANFrame(tCANId, tFrameLength, tFrameData);
+    }
+    storePylontechSentCANData(tCANId, tFrameLength, tFrameData);
+    return false;
+}
+
 /*
  * Inverter reply every second: 0x305: 00-00-00-00-00-00-00-00
  * If no CAN receiver is attached, every frame is retransmitted once, because of the NACK error.
  * Or use CAN.writeRegister(REG_CANCTRL, 0x08); // One Shot Mode
+ * All frames were just sent, so each frame is next sent one period later.
+ * The offset is not added again, it only spreads the frames at the start of the schedule.
+ * A frame which could not be appended to the transmit queue stays due and is sent by handlePylontechCANSchedule().
  */
 void sendPylontechAllCANFrames(bool aDebugModeActive) {
-    if (aDebugModeActive) {
-        ControlChargeScheme(); //modify charge scheme
-        printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatteryLimitsFrame));
-        printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANSohSocFrame));
-        printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCurrentValuesFrame));
-        printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANManufacturerFrame));
-        printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatteryRequestFrame));
-        printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANAliveFrame));
-        printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANErrorsWarningsFrame));
-#if defined(SMA_EXTENSIONS)
-        printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANSpecificationsFrame));
-#endif
-#if defined(LUXPOWER_EXTENSIONS)
-    //sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatInfoFrame));
-    //sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCellInfoFrame));
-    //sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCellMinVoltageNameFrame));
-    //sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCellMaxVoltageNameFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANLuxpowerCapacityFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANSMACapacityFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCellInfoFrame));
-    //sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatteryInfoFrame));
-#endif
+    uint16_t tMillis = millis();
+    for (uint_fast8_t i = 0; i < PYLON_CAN_NUMBER_OF_SCHEDULED_FRAMES; ++i) {
+        if (sendPylontechCANFrame(i, aDebugModeActive)) {
+            sPylontechCANNextSendMillis[i] = tMillis;
+        } else {
+            sPylontechCANNextSendMillis[i] = tMillis + pgm_read_word(&PylontechCANSchedule[i].PeriodMillis);
+        }
     }
-    ControlChargeScheme(); //modify charge scheme
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatteryLimitsFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANSohSocFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCurrentValuesFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANManufacturerFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatteryRequestFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANAliveFrame));
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANErrorsWarningsFrame));
-#if defined(SMA_EXTENSIONS)
-    sendPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANSpecificationsFrame));
+    sPylontechCANScheduleIsStarted = true;
+}
+
+/*
+ * Must be called in every loop, if frames can be sent. Sends all frames which are due.
+ * The next due time is kept in the slot given by period and offset, as long as we are not more than one period late.
+ * A frame which could not be appended to the transmit queue stays due and is tried again at the next call.
+ * @return true if a frame was sent
+ */
+bool handlePylontechCANSchedule(bool aDebugModeActive) {
+    bool tFrameWasSent = false;
+    uint16_t tMillis = millis();
+    if (!sPylontechCANScheduleIsStarted) {
+        sPylontechCANScheduleIsStarted = true;
+        for (uint_fast8_t i = 0; i < PYLON_CAN_NUMBER_OF_SCHEDULED_FRAMES; ++i) {
+            sPylontechCANNextSendMillis[i] = tMillis + pgm_read_word(&PylontechCANSchedule[i].OffsetMillis);
+        }
+    }
+
+    for (uint_fast8_t i = 0; i < PYLON_CAN_NUMBER_OF_SCHEDULED_FRAMES; ++i) {
+        if ((int16_t) (tMillis - sPylontechCANNextSendMillis[i]) >= 0) {
+            if (sendPylontechCANFrame(i, aDebugModeActive)) {
+                continue; // Transmit queue is full
+            }
+            tFrameWasSent = true;
+            uint16_t tPeriodMillis = pgm_read_word(&PylontechCANSchedule[i].PeriodMillis);
+            sPylontechCANNextSendMillis[i] += tPeriodMillis;
+            if ((int16_t) (tMillis - sPylontechCANNextSendMillis[i]) >= 0) {
+                sPylontechCANNextSendMillis[i] = tMillis + tPeriodMillis;
+            }
+        }
+    }
+    return tFrameWasSent;
+}
+
+/*
+ * Used for sleeping between the frames
+ * @return milliseconds until the next frame is due, 0 if a frame is due now and 0xFFFF if schedule is not started
+ */
+uint16_t getMillisUntilNextPylontechCANFrame() {
+    if (!sPylontechCANScheduleIsStarted) {
+        return 0xFFFF;
+    }
+    uint16_t tMillis = millis();
+    uint16_t tMinimumMillis = 0xFFFF;
+    for (uint_fast8_t i = 0; i < PYLON_CAN_NUMBER_OF_SCHEDULED_FRAMES; ++i) {
+        int16_t tMillisUntilDue = sPylontechCANNextSendMillis[i] - tMillis;
+        if (tMillisUntilDue <= 0) {
+            return 0;
+        }
+        if ((uint16_t) tMillisUntilDue < tMinimumMillis) {
+            tMinimumMillis = tMillisUntilDue;
+        }
+    }
+    return tMinimumMillis;
+}
+
+void setPylontechCANFrameDue(uint16_t aCANId) {
+    for (uint_fast8_t i = 0; i < PYLON_CAN_NUMBER_OF_SCHEDULED_FRAMES; ++i) {
+        if (pgm_read_word(&PylontechCANSchedule[i].CANId) == aCANId) {
+            sPylontechCANNextSendMillis[i] = millis();
+        }
+    }
+}
+
+/*
+ * Called after new BMS data was filled. Frames which changed since their last sending, are set due for immediate sending.
+ * return true if a frame changed
+ */
+bool schedulePylontechChangedCANFrames() {
+    bool tFrameChanged = false;
+    if (memcmp(&PylontechCANErrorsWarningsFrame.FrameData, sLastSentErrorsWarningsData,
+            PylontechCANErrorsWarningsFrame.FrameLength) != 0) {
+        setPylontechCANFrameDue(PylontechCANErrorsWarningsFrame.CANId);
+        tFrameChanged = true;
+    }
+    if (memcmp(&PylontechCANBatteryRequestFrame.FrameData, sLastSentBatteryRequestData,
+            PylontechCANBatteryRequestFrame.FrameLength) != 0) {
+        setPylontechCANFrameDue(PylontechCANBatteryRequestFrame.CANId);
+        tFrameChanged = true;
+    }
+    if (memcmp(&PylontechCANBatteryLimitsFrame.FrameData, sLastSentBatteryLimitsData,
+            PylontechCANBatteryLimitsFrame.FrameLength) != 0) {
+        setPylontechCANFrameDue(PylontechCANBatteryLimitsFrame.CANId);
+        tFrameChanged = true;
+    }
+
+    int16_t tVoltageDifference = PylontechCANCurrentValuesFrame.FrameData.Voltage10Millivolt - sLastSentVoltage10Millivolt;
+    int16_t tCurrentDifference = PylontechCANCurrentValuesFrame.FrameData.Current100Milliampere - sLastSentCurrent100Milliampere;
+    if (abs(tVoltageDifference) >= CAN_VOLTAGE_DEADBAND_10_MILLIVOLT || abs(tCurrentDifference) >= CAN_CURRENT_DEADBAND_100_MILLIAMPERE) {
+        setPylontechCANFrameDue(PylontechCANCurrentValuesFrame.CANId);
+        tFrameChanged = true;
+    }
+
+    int16_t tSOCDifference = PylontechCANSohSocFrame.FrameData.SOCPercent - sLastSentSOCPercent;
+    if (abs(tSOCDifference) >= CAN_SOC_DEADBAND_PERCENT) {
+        setPylontechCANFrameDue(PylontechCANSohSocFrame.CANId);
+        tFrameChanged = true;
+    }
+    return tFrameChanged;
+}
+
+/*
+ * The inverter sends 0x305: 00-00-00-00-00-00-00-00 as reply to our frames or on its own schedule.
+ */
+uint32_t sMillisOfLastCANReceiveCheck;
+uint32_t sMillisOfLastInverterCANFrame;
+bool sInverterIsAlive = false;
+uint16_t sInverterReplyMillis;          // Time from sending our frames until the next inverter frame, i.e. the round trip time
+uint16_t sNumberOfInverterCANFrames;
+
+/*
+ * Must be called in every loop. Reads all received frames every MILLISECONDS_BETWEEN_CAN_RECEIVE_CHECKS
+ * and prints if the inverter appears or no inverter frame was received for INVERTER_TIMEOUT_MILLIS.
+ * return true if an inverter frame was received
+ */
+bool handleInverterCANFrames(uint32_t aMillisOfLastCANFrameSent) {
+    uint32_t tMillis = millis();
+    if (tMillis - sMillisOfLastCANReceiveCheck < MILLISECONDS_BETWEEN_CAN_RECEIVE_CHECKS) {
+        return false;
+    }
+    sMillisOfLastCANReceiveCheck = tMillis;
+
+    bool tInverterFrameReceived = false;
+    uint16_t tCANId;
+    uint8_t tLength;
+    uint8_t tData[8];
+    while (receiveCANMessage(&tCANId, &tLength, tData)) {
+        // Only frames with MCP2515_RX_FILTER_ID_0 or MCP2515_RX_FILTER_ID_1 pass the filters
+        tInverterFrameReceived = true;
+        sNumberOfInverterCANFrames++;
+#if defined(LOCAL_DEBUG)
+        Serial.print(F("Received CANId=0x"));
+        Serial.println(tCANId, HEX);
 #endif
-#if defined(LUXPOWER_EXTENSIONS)        
-    //printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatInfoFrame));
-    //printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCellInfoFrame));
-    //printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCellMinVoltageNameFrame));
-    //printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCellMaxVoltageNameFrame));
-    printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANLuxpowerCapacityFrame));
-    printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANSMACapacityFrame));  
-    printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANCellInfoFrame));  
-    //printPylontechCANFrame(reinterpret_cast<struct PylontechCANFrameStruct*>(&PylontechCANBatteryInfoFrame));     
-#endif  
+    }
+
+    if (tInverterFrameReceived) {
+        if ((int32_t) (sMillisOfLastInverterCANFrame - aMillisOfLastCANFrameSent) < 0) {
+            // First inverter frame after our last transmission
+            sInverterReplyMillis = tMillis - aMillisOfLastCANFrameSent;
+        }
+        sMillisOfLastInverterCANFrame = tMillis;
+        if (!sInverterIsAlive) {
+            sInverterIsAlive = true;
+            Serial.println(F("Inverter CAN frame received"));
+        }
+    } else if (sInverterIsAlive && tMillis - sMillisOfLastInverterCANFrame > INVERTER_TIMEOUT_MILLIS) {
+        sInverterIsAlive = false;
+        Serial.println(F("No inverter CAN frame received for " STR(INVERTER_TIMEOUT_MILLIS) " ms"));
+    }
+    return tInverterFrameReceived;
 }
 
 /* This part is for controlling the charge scheme 
@@ -153,7 +370,11 @@ void ControlChargeScheme(){
   uint8_t ChargeStatusRef = 0;
   uint16_t Local_Charge_Current_100_milliAmp;
   
+#if defined(USE_FIXED_POINT)
+  if (JKComputedData.BatteryLoadCurrent10Milliampere > 0) {
+#else
   if (JKComputedData.BatteryLoadCurrentFloat > 0) {
+#endif
     ChargeStatusRef = ReachChargeLimit();
     if (StartChargeTime == 0) {
       if (ChargeStatusRef >= 1 && ChargeTryEffort > 2){
@@ -167,8 +388,8 @@ void ControlChargeScheme(){
       }
       StartChargeTime = millis(); // Store starting time for charge
       // Get the proper charging current: either BMS limit or using 0.3C
-      Computed_Current_limits_100mA = min(swap(sJKFAllReplyPointer->ChargeOvercurrentProtectionAmpere) * 10, 
-      JKComputedData.TotalCapacityAmpereHour * CHARGING_CURRENT_PER_CAPACITY);
+      Computed_Current_limits_100mA = min(sJKFAllReplyPointer->ChargeOvercurrentProtectionAmpere * 10, 
+      sJKFAllReplyPointer->TotalCapacityAmpereHour * CHARGING_CURRENT_PER_CAPACITY);
       Serial.print(F("Charging check: >Selected Current:")); Serial.println(Computed_Current_limits_100mA);   
     }
   } else {
@@ -183,7 +404,11 @@ void ControlChargeScheme(){
     if ((millis() - StartChargeTime) < MOMENTARY_CHARGE_DURATION) return;
     // Charge started in more than MOMENTARY_CHARGE_DURATION, charging started, get into phase 1
     //MinuteCount = MOMENTARY_CHARGE_DURATION / (CHARGE_RATIO * 1000L); // Marking the counter for warming up charge
+#if defined(USE_FIXED_POINT)
+    MinuteCount = map(JKComputedData.BatteryLoadCurrent10Milliampere / 10, 1, Computed_Current_limits_100mA, 0, CHARGE_PHASE_1) + 1;
+#else
     MinuteCount = map(JKComputedData.BatteryLoadCurrentFloat * 10, 1, Computed_Current_limits_100mA, 0, CHARGE_PHASE_1) + 1;
+#endif
     ChargePhase = 1;
     Serial.println(F("Enter phase 1:"));
     Serial.print(MinuteCount);
@@ -260,8 +485,8 @@ void resetCharge(){
   ChargePhase = 0;
   ChargeTryEffort = 0;    
   // recover the charging limits
-  if (PylontechCANBatteryLimitsFrame.FrameData.BatteryChargeCurrentLimit100Milliampere != swap(sJKFAllReplyPointer->ChargeOvercurrentProtectionAmpere) * 10) {
-    PylontechCANBatteryLimitsFrame.FrameData.BatteryChargeCurrentLimit100Milliampere = swap(sJKFAllReplyPointer->ChargeOvercurrentProtectionAmpere) * 10;
+  if (PylontechCANBatteryLimitsFrame.FrameData.BatteryChargeCurrentLimit100Milliampere != sJKFAllReplyPointer->ChargeOvercurrentProtectionAmpere * 10) {
+    PylontechCANBatteryLimitsFrame.FrameData.BatteryChargeCurrentLimit100Milliampere = sJKFAllReplyPointer->ChargeOvercurrentProtectionAmpere * 10;
   }
 }
 
@@ -275,14 +500,14 @@ uint8_t ReachChargeLimit(){
   uint16_t Charge_MilliVolt_limit = 0;  
   if ((millis() - LastCheckTime) < CHARGE_STATUS_REFRESH_INTERVAL) return 0;
   // first check over voltage
-  if (JKComputedData.BatteryType == 0) {//LFP battery  
+  if (sJKFAllReplyPointer->BatteryType == 0) {//LFP battery  
     Charge_MilliVolt_limit = 3450;
-  } else if (JKComputedData.BatteryType == 1){ //Lithium ion       
+  } else if (sJKFAllReplyPointer->BatteryType == 1){ //Lithium ion       
     Charge_MilliVolt_limit = 4200;  
   }
   // check SOC First
   return (sJKFAllReplyPointer->SOCPercent >= MAX_SOC_BULK_CHARGE_THRESHOLD_PERCENT)? 1 : 0;   
-  Serial.print(F("Battery type:")); Serial.println(JKComputedData.BatteryType);
+  Serial.print(F("Battery type:")); Serial.println(sJKFAllReplyPointer->BatteryType);
   if ((JKComputedData.MaximumCellMillivolt * 1.02) > Charge_MilliVolt_limit) {
     Serial.print(F("Status check::")); Serial.println((JKComputedData.MaximumCellMillivolt * 1.02) - Charge_MilliVolt_limit);    
     return 2;  
@@ -0,0 +1,45 @@
+/*
+ * TWI_TX.h
+ *
+ * Interrupt driven transmit only TWI (I2C) master for the ATmega328 with a transmit queue for one slave.
+ * The bytes are queued by TWITXWrite() and sent at 400 kHz by ISR(TWI_vect) without blocking the main loop.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+
+#ifndef _TWI_TX_H
+#define _TWI_TX_H
+
+#include <stdint.h>
+
+#if !defined(TWI_TX_BUFFER_SIZE)
+#define TWI_TX_BUFFER_SIZE  64      // 10 LCD characters, must be a power of 2
+#endif
+#define TWI_TX_CLOCK        400000  // 400 kHz fast mode
+
+void initTWITX(uint8_t aSlaveAddress);
+void handleTWITXInterrupt();
+void TWITXWrite(uint8_t aByte);
+bool isTWITXComplete();
+void waitForTWITXComplete();
+
+extern volatile uint16_t sTWITXNackCount; // Number of transactions stopped, because the slave did not acknowledge
+
+#endif // _TWI_TX_H
@@ -0,0 +1,129 @@
+/*
+ * TWI_TX.hpp
+ *
+ * Interrupt driven transmit only TWI (I2C) master for the ATmega328 with a transmit queue for one slave.
+ * All bytes queued while a transaction is running are sent in this transaction. The transaction is stopped if the queue is empty.
+ * If the slave does not acknowledge, the transaction is stopped and the queue is discarded.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+
+#ifndef _TWI_TX_HPP
+#define _TWI_TX_HPP
+
+#include <Arduino.h>
+#include <util/twi.h>
+#include "TWI_TX.h"
+
+uint8_t sTWITXSlaveAddressAndWriteBit;
+uint8_t sTWITXBuffer[TWI_TX_BUFFER_SIZE];
+volatile uint8_t sTWITXBufferHead = 0;  // Index of next byte to write to buffer
+volatile uint8_t sTWITXBufferTail = 0;  // Index of next byte to send
+volatile bool sTWITXIsActive = false;   // True from START until STOP condition is requested
+volatile uint16_t sTWITXNackCount = 0;
+
+/*
+ * Sets 400 kHz clock and enables the TWI and the internal pullups
+ */
+void initTWITX(uint8_t aSlaveAddress) {
+    sTWITXSlaveAddressAndWriteBit = (aSlaveAddress << 1) | TW_WRITE;
+    digitalWrite(SDA, HIGH);
+    digitalWrite(SCL, HIGH);
+    TWSR = 0; // no prescaler
+    TWBR = ((F_CPU / TWI_TX_CLOCK) - 16) / 2;
+    TWCR = _BV(TWEN);
+}
+
+/*
+ * Sends the slave address after the START condition and then the queued bytes.
+ * Called by ISR or by TWITXWrite() if interrupts are disabled.
+ */
+void handleTWITXInterrupt() {
+    uint8_t tStatus = TW_STATUS;
+    if (tStatus == TW_START || tStatus == TW_REP_START) {
+        TWDR = sTWITXSlaveAddressAndWriteBit;
+        TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+
+    } else if ((tStatus == TW_MT_SLA_ACK || tStatus == TW_MT_DATA_ACK) && sTWITXBufferHead != sTWITXBufferTail) {
+        uint8_t tTail = sTWITXBufferTail;
+        TWDR = sTWITXBuffer[tTail];
+        sTWITXBufferTail = (tTail + 1) % TWI_TX_BUFFER_SIZE;
+        TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+
+    } else {
+        if (tStatus != TW_MT_SLA_ACK && tStatus != TW_MT_DATA_ACK) {
+            // NACK, arbitration lost or bus error
+            sTWITXNackCount++;
+            sTWITXBufferTail = sTWITXBufferHead;
+        }
+        TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO); // Queue is empty, release the bus and disable TWI interrupt
+        sTWITXIsActive = false;
+    }
+}
+
+ISR(TWI_vect) {
+    handleTWITXInterrupt();
+}
+
+/*
+ * Queues the byte and starts a transaction if none is active.
+ */
+void TWITXWrite(uint8_t aByte) {
+    uint8_t tNextHead = (sTWITXBufferHead + 1) % TWI_TX_BUFFER_SIZE;
+    /*
+     * Wait for the ISR to make space in the buffer.
+     * If interrupts are disabled, e.g. if called from an ISR, we must do the job of the ISR here.
+     */
+    while (tNextHead == sTWITXBufferTail) {
+        if (bit_is_clear(SREG, SREG_I) && bit_is_set(TWCR, TWINT)) {
+            handleTWITXInterrupt();
+        }
+    }
+    sTWITXBuffer[sTWITXBufferHead] = aByte;
+
+    uint8_t tSREG = SREG;
+    cli();
+    sTWITXBufferHead = tNextHead;
+    if (!sTWITXIsActive) {
+        sTWITXIsActive = true;
+        while (TWCR & _BV(TWSTO)) {
+            // Wait for the STOP condition of the last transaction to be executed, this takes around 2 us
+        }
+        TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTA) | _BV(TWIE);
+    }
+    SREG = tSREG;
+}
+
+/*
+ * Return true if queue is empty and the last transaction is stopped
+ */
+bool isTWITXComplete() {
+    return !(TWCR & _BV(TWSTO)) && !sTWITXIsActive;
+}
+
+/*
+ * Used before delays, which must start after the transmission
+ */
+void waitForTWITXComplete() {
+    while (!isTWITXComplete()) {
+        // Wait for ISR to send all bytes
+    }
+}
+#endif // _TWI_TX_HPP
@@ -0,0 +1,763 @@
+/*
+ * HostArduino.cpp
+ *
+ * Virtual clock and host implementation of the Arduino core functions and libraries used by JK-BMSToPylontechCAN.ino.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#include <queue>
+#include <vector>
+
+#include <Arduino.h>
+#include <util/twi.h>
+#include <SPI.h>
+#include <Wire.h>
+#include "HostEasyButton.h"
+#include "SoftwareSerialTX.h"
+
+HostIOCounters sHostIOCounters;
+HostOptions sHostOptions;
+
+/*
+ * Virtual clock and event queue
+ */
+struct SimulationEvent {
+    uint64_t Nanos;
+    uint32_t SequenceNumber; // keeps events with identical time in order of scheduling
+    void (*Handler)(uintptr_t aParameter);
+    uintptr_t Parameter;
+    bool operator>(const SimulationEvent &aOther) const {
+        if (Nanos != aOther.Nanos) {
+            return Nanos > aOther.Nanos;
+        }
+        return SequenceNumber > aOther.SequenceNumber;
+    }
+};
+
+static std::priority_queue<SimulationEvent, std::vector<SimulationEvent>, std::greater<SimulationEvent> > sEventQueue;
+static uint64_t sSimulationNanos = 0;
+static uint32_t sEventSequenceNumber = 0;
+
+uint64_t getSimulationNanos() {
+    return sSimulationNanos;
+}
+
+/*
+ * Processes all events which are due until the new time.
+ * May be called recursively by an ISR called by an event, so time must never go backwards.
+ */
+void advanceSimulationNanos(uint64_t aNanos) {
+    uint64_t tTargetNanos = sSimulationNanos + aNanos;
+    while (!sEventQueue.empty() && sEventQueue.top().Nanos <= tTargetNanos) {
+        SimulationEvent tEvent = sEventQueue.top();
+        sEventQueue.pop();
+        if (tEvent.Nanos > sSimulationNanos) {
+            sSimulationNanos = tEvent.Nanos;
+        }
+        tEvent.Handler(tEvent.Parameter);
+    }
+    if (sSimulationNanos < tTargetNanos) {
+        sSimulationNanos = tTargetNanos;
+    }
+}
+
+void hostDelayUntil(uint64_t aNanos) {
+    if (aNanos > sSimulationNanos) {
+        advanceSimulationNanos(aNanos - sSimulationNanos);
+    }
+}
+
+void scheduleSimulationEvent(uint64_t aNanosFromNow, void (*aHandler)(uintptr_t aParameter), uintptr_t aParameter) {
+    SimulationEvent tEvent;
+    tEvent.Nanos = sSimulationNanos + aNanosFromNow;
+    tEvent.SequenceNumber = sEventSequenceNumber++;
+    tEvent.Handler = aHandler;
+    tEvent.Parameter = aParameter;
+    sEventQueue.push(tEvent);
+}
+
+/*
+ * Timing
+ */
+unsigned long millis() {
+    return (uint32_t) (sSimulationNanos / 1000000);
+}
+
+unsigned long micros() {
+    return (uint32_t) (sSimulationNanos / 1000);
+}
+
+void delay(unsigned long aMillis) {
+    advanceSimulationNanos((uint64_t) aMillis * 1000000);
+}
+
+void delayMicroseconds(unsigned int aMicros) {
+    advanceSimulationNanos((uint64_t) aMicros * 1000);
+}
+
+/*
+ * sei and cli take one cycle
+ */
+void interrupts() {
+    advanceSimulationNanos(HOST_REGISTER_ACCESS_NANOS);
+    SREG.Value |= _BV(SREG_I);
+    hostCheckInterrupts();
+}
+void noInterrupts() {
+    advanceSimulationNanos(HOST_REGISTER_ACCESS_NANOS);
+    SREG.Value &= ~_BV(SREG_I);
+}
+
+HostRegister::operator uint8_t() {
+    advanceSimulationNanos(HOST_REGISTER_ACCESS_NANOS);
+    if (ReadFunction != NULL) {
+        return ReadFunction();
+    }
+    return Value;
+}
+
+HostRegister& HostRegister::operator=(uint8_t aValue) {
+    advanceSimulationNanos(HOST_REGISTER_ACCESS_NANOS);
+    if (WriteFunction != NULL) {
+        WriteFunction(aValue);
+    } else {
+        Value = aValue;
+    }
+    return *this;
+}
+
+/*
+ * Pins. Only the chip select of the MCP2515 has a function.
+ */
+static uint8_t sHostCANChipSelectPin = 9;
+
+void hostSetCANChipSelectPin(uint8_t aPin) {
+    sHostCANChipSelectPin = aPin;
+}
+
+void pinMode(uint8_t aPin, uint8_t aMode) {
+    (void) aPin;
+    (void) aMode;
+}
+
+void digitalWrite(uint8_t aPin, uint8_t aValue) {
+    advanceSimulationNanos(HOST_DIGITAL_WRITE_NANOS);
+    if (aPin == sHostCANChipSelectPin) {
+        hostMCP2515SetChipSelect(aValue == LOW);
+    }
+}
+
+int digitalRead(uint8_t aPin) {
+    (void) aPin;
+    return HIGH;
+}
+
+void tone(uint8_t aPin, unsigned int aFrequency, unsigned long aDuration) {
+    (void) aPin;
+    (void) aFrequency;
+    (void) aDuration;
+    sHostIOCounters.ToneCalls++;
+}
+
+void noTone(uint8_t aPin) {
+    (void) aPin;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+char* dtostrf(double aValue, signed char aWidth, unsigned char aPrecision, char *aBuffer) {
+    sprintf(aBuffer, "%*.*f", aWidth, aPrecision, aValue);
+    return aBuffer;
+}
+
+/*
+ * ADC registers for isVCCTooHighSimple(). Raw reading of 1.1 V is 225 at 5 V.
+ */
+uint8_t ADMUX;
+uint8_t ADCSRA;
+uint8_t ADCL = 225;
+uint8_t ADCH = 0;
+
+/*
+ * Print with the number formatting of the Arduino core. long and int are 32 bit and 16 bit on AVR,
+ * so non decimal numbers are printed with 32 bit, as on the AVR.
+ */
+size_t Print::write(const uint8_t *aBuffer, size_t aSize) {
+    size_t n = 0;
+    while (aSize--) {
+        if (write(*aBuffer++)) {
+            n++;
+        } else {
+            break;
+        }
+    }
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper *aPGMString) {
+    return write(reinterpret_cast<const char*>(aPGMString));
+}
+
+size_t Print::print(const char aString[]) {
+    return write(aString);
+}
+
+size_t Print::print(char aChar) {
+    return write((uint8_t) aChar);
+}
+
+size_t Print::print(unsigned char aNumber, int aBase) {
+    return print((unsigned long) aNumber, aBase);
+}
+
+size_t Print::print(int aNumber, int aBase) {
+    return print((long) aNumber, aBase);
+}
+
+size_t Print::print(unsigned int aNumber, int aBase) {
+    return print((unsigned long) aNumber, aBase);
+}
+
+size_t Print::print(long aNumber, int aBase) {
+    if (aBase == 0) {
+        return write((uint8_t) aNumber);
+    } else if (aBase == 10) {
+        if (aNumber < 0) {
+            int t = print('-');
+            return printNumber(-aNumber, 10) + t;
+        }
+        return printNumber(aNumber, 10);
+    } else {
+        return printNumber((uint32_t) aNumber, aBase);
+    }
+}
+
+size_t Print::print(unsigned long aNumber, int aBase) {
+    if (aBase == 0) {
+        return write((uint8_t) aNumber);
+    }
+    return printNumber(aNumber, aBase);
+}
+
+size_t Print::print(long long aNumber, int aBase) {
+    if (aBase == 0) {
+        return write((uint8_t) aNumber);
+    } else if (aBase == 10 && aNumber < 0) {
+        int t = print('-');
+        return printNumber(-aNumber, 10) + t;
+    }
+    return printNumber(aNumber, aBase);
+}
+
+size_t Print::print(unsigned long long aNumber, int aBase) {
+    if (aBase == 0) {
+        return write((uint8_t) aNumber);
+    }
+    return printNumber(aNumber, aBase);
+}
+
+size_t Print::print(double aNumber, int aDigits) {
+    return printFloat(aNumber, aDigits);
+}
+
+size_t Print::println(void) {
+    return write("\r\n");
+}
+
+#define HOST_PRINTLN(aType) \
+size_t Print::println(aType aValue) { \
+    size_t n = print(aValue); \
+    return n + println(); \
+}
+#define HOST_PRINTLN_BASE(aType) \
+size_t Print::println(aType aValue, int aBase) { \
+    size_t n = print(aValue, aBase); \
+    return n + println(); \
+}
+HOST_PRINTLN(const __FlashStringHelper *)
+HOST_PRINTLN(const char*)
+HOST_PRINTLN(char)
+HOST_PRINTLN_BASE(unsigned char)
+HOST_PRINTLN_BASE(int)
+HOST_PRINTLN_BASE(unsigned int)
+HOST_PRINTLN_BASE(long)
+HOST_PRINTLN_BASE(unsigned long)
+HOST_PRINTLN_BASE(long long)
+HOST_PRINTLN_BASE(unsigned long long)
+HOST_PRINTLN_BASE(double)
+
+size_t Print::printNumber(unsigned long long aNumber, uint8_t aBase) {
+    char tBuffer[8 * sizeof(long long) + 1];
+    char *tStringPointer = &tBuffer[sizeof(tBuffer) - 1];
+    *tStringPointer = '\0';
+
+    if (aBase < 2) {
+        aBase = 10;
+    }
+    do {
+        char c = aNumber % aBase;
+        aNumber /= aBase;
+        *--tStringPointer = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (aNumber);
+
+    return write(tStringPointer);
+}
+
+size_t Print::printFloat(double aNumber, uint8_t aDigits) {
+    size_t n = 0;
+
+    if (isnan(aNumber)) {
+        return print("nan");
+    }
+    if (isinf(aNumber)) {
+        return print("inf");
+    }
+    if (aNumber > 4294967040.0 || aNumber < -4294967040.0) {
+        return print("ovf");
+    }
+
+    if (aNumber < 0.0) {
+        n += print('-');
+        aNumber = -aNumber;
+    }
+
+    // Round correctly so that print(1.999, 2) prints as "2.00"
+    double tRounding = 0.5;
+    for (uint8_t i = 0; i < aDigits; ++i) {
+        tRounding /= 10.0;
+    }
+    aNumber += tRounding;
+
+    unsigned long tIntPart = (unsigned long) aNumber;
+    double tRemainder = aNumber - (double) tIntPart;
+    n += print(tIntPart);
+
+    if (aDigits > 0) {
+        n += print('.');
+    }
+    while (aDigits-- > 0) {
+        tRemainder *= 10.0;
+        unsigned int tToPrint = (unsigned int) tRemainder;
+        n += print(tToPrint);
+        tRemainder -= tToPrint;
+    }
+    return n;
+}
+
+/*
+ * USART0 at 115200 baud with the 2 byte receive FIFO, the transmit data register and the transmit shift register of the ATmega328
+ */
+struct HostUSARTRXFIFOEntry {
+    uint8_t Data;
+    bool IsLastByteOfFrame; // For counting the frames read
+};
+#define HOST_USART_RX_FIFO_SIZE 2
+static HostUSARTRXFIFOEntry sUSARTRXFIFO[HOST_USART_RX_FIFO_SIZE];
+static uint8_t sUSARTRXFIFOCount = 0;
+static uint8_t sUSARTTXDataRegister;
+static bool sUSARTTXDataRegisterIsFull = false;
+static bool sUSARTTXShiftRegisterIsBusy = false;
+static bool sIsInISR = false;
+
+static void writeSREG(uint8_t aValue) {
+    SREG.Value = aValue;
+    hostCheckInterrupts();
+}
+
+static uint8_t readUDR0() {
+    if (sUSARTRXFIFOCount == 0) {
+        return 0;
+    }
+    HostUSARTRXFIFOEntry tEntry = sUSARTRXFIFO[0];
+    sUSARTRXFIFO[0] = sUSARTRXFIFO[1];
+    sUSARTRXFIFOCount--;
+    if (sUSARTRXFIFOCount == 0) {
+        UCSR0A.Value &= ~_BV(RXC0);
+    }
+    UCSR0A.Value &= ~_BV(DOR0);
+    sHostIOCounters.SerialRXBytesRead++;
+    if (tEntry.IsLastByteOfFrame) {
+        sHostIOCounters.SerialRXFramesRead++;
+    }
+    return tEntry.Data;
+}
+
+static void startUSARTTransmit(uint8_t aByte);
+
+static void handleUSARTTransmitComplete(uintptr_t aParameter) {
+    (void) aParameter;
+    if (sUSARTTXDataRegisterIsFull) {
+        sUSARTTXDataRegisterIsFull = false;
+        UCSR0A.Value |= _BV(UDRE0);
+        startUSARTTransmit(sUSARTTXDataRegister);
+    } else {
+        sUSARTTXShiftRegisterIsBusy = false;
+        UCSR0A.Value |= _BV(TXC0);
+    }
+    hostCheckInterrupts();
+}
+
+static void startUSARTTransmit(uint8_t aByte) {
+    sUSARTTXShiftRegisterIsBusy = true;
+    sHostIOCounters.SerialTXBytes++;
+    if (sHostOptions.PrintSerialOutput) {
+        putchar(aByte);
+    }
+    scheduleSimulationEvent(HOST_UART_BYTE_NANOS, &handleUSARTTransmitComplete, 0);
+}
+
+/*
+ * Writes outside of an ISR are the fast path of Serial.write()
+ */
+static void writeUDR0(uint8_t aValue) {
+    if (!sIsInISR) {
+        sHostIOCounters.SerialTXWrites++;
+    }
+    if (!(UCSR0A.Value & _BV(UDRE0))) {
+        return; // Data register is full, the byte is lost
+    }
+    if (!sUSARTTXShiftRegisterIsBusy) {
+        startUSARTTransmit(aValue);
+    } else {
+        sUSARTTXDataRegister = aValue;
+        sUSARTTXDataRegisterIsFull = true;
+        UCSR0A.Value &= ~_BV(UDRE0);
+    }
+}
+
+/*
+ * Only U2X0 and MPCM0 are writable, TXC0 is cleared by writing a one to it
+ */
+static void writeUCSR0A(uint8_t aValue) {
+    uint8_t tWritableMask = _BV(U2X0) | _BV(MPCM0);
+    UCSR0A.Value = (UCSR0A.Value & ~tWritableMask) | (aValue & tWritableMask);
+    if (aValue & _BV(TXC0)) {
+        UCSR0A.Value &= ~_BV(TXC0);
+    }
+}
+
+/*
+ * Enabling the data register empty interrupt outside of an ISR is the buffered path of Serial.write()
+ */
+static void writeUCSR0B(uint8_t aValue) {
+    if (!sIsInISR && (aValue & _BV(UDRIE0))) {
+        sHostIOCounters.SerialTXWrites++;
+    }
+    UCSR0B.Value = aValue;
+    hostCheckInterrupts();
+}
+
+HostRegister SREG(_BV(SREG_I), NULL, &writeSREG); // Interrupts are enabled by init() of the Arduino core
+HostRegister UDR0(0, &readUDR0, &writeUDR0);
+HostRegister UCSR0A(_BV(UDRE0), NULL, &writeUCSR0A);
+HostRegister UCSR0B(0, NULL, &writeUCSR0B);
+HostRegister UCSR0C(_BV(UCSZ01) | _BV(UCSZ00));
+HostRegister UBRR0H(0);
+HostRegister UBRR0L(0);
+
+/*
+ * Called by the JK-BMS model at the time the stop bit of a byte is received
+ */
+void hostSerialReceiveByte(uint8_t aByte, bool aIsLastByteOfFrame) {
+    if (!(UCSR0B.Value & _BV(RXEN0))) {
+        return;
+    }
+    if (sUSARTRXFIFOCount == HOST_USART_RX_FIFO_SIZE) {
+        // FIFO full, byte is discarded like on the AVR
+        UCSR0A.Value |= _BV(DOR0);
+        sHostIOCounters.SerialRXOverruns++;
+        return;
+    }
+    sUSARTRXFIFO[sUSARTRXFIFOCount].Data = aByte;
+    sUSARTRXFIFO[sUSARTRXFIFOCount].IsLastByteOfFrame = aIsLastByteOfFrame;
+    sUSARTRXFIFOCount++;
+    UCSR0A.Value |= _BV(RXC0);
+    hostCheckInterrupts();
+}
+
+/*
+ * TWI master transmitter at 400 kHz. The data bytes to the LCD address go to the simulated PCF8574 / HD44780 LCD.
+ * An operation is started by writing TWCR with TWINT set and ends with TWINT set again, except the STOP condition.
+ */
+static bool sTWIIsAddressPhase = false;
+static bool sTWISlaveIsLCD = false;
+
+static void handleTWIOperationComplete(uintptr_t aStatus) {
+    TWSR.Value = (TWSR.Value & ~TW_STATUS_MASK) | aStatus;
+    TWCR.Value |= _BV(TWINT);
+    hostCheckInterrupts();
+}
+
+static void handleTWIStopComplete(uintptr_t aParameter) {
+    (void) aParameter;
+    TWCR.Value &= ~_BV(TWSTO);
+}
+
+static void writeTWCR(uint8_t aValue) {
+    bool tStartOperation = (aValue & _BV(TWINT)) && (aValue & _BV(TWEN));
+    TWCR.Value = (TWCR.Value & _BV(TWINT)) | (aValue & ~_BV(TWINT));
+    if (tStartOperation) {
+        TWCR.Value &= ~_BV(TWINT); // Writing a one clears the flag
+        if (!sIsInISR) {
+            sHostIOCounters.I2CWrites++;
+        }
+        if (aValue & _BV(TWSTO)) {
+            scheduleSimulationEvent(HOST_I2C_START_STOP_NANOS, &handleTWIStopComplete, 0);
+        } else if (aValue & _BV(TWSTA)) {
+            sTWIIsAddressPhase = true;
+            scheduleSimulationEvent(HOST_I2C_START_STOP_NANOS, &handleTWIOperationComplete, TW_START);
+        } else {
+            sHostIOCounters.I2CBytes++;
+            uint8_t tStatus;
+            if (sTWIIsAddressPhase) {
+                sTWIIsAddressPhase = false;
+                sTWISlaveIsLCD = (TWDR.Value >> 1) == HOST_LCD_I2C_ADDRESS && sHostOptions.LCDIsAttached;
+                tStatus = sTWISlaveIsLCD ? TW_MT_SLA_ACK : TW_MT_SLA_NACK;
+            } else {
+                // The PCF8574 outputs change at the acknowledge of the byte
+                if (sTWISlaveIsLCD) {
+                    hostLCDExpanderWrite(TWDR.Value);
+                }
+                tStatus = sTWISlaveIsLCD ? TW_MT_DATA_ACK : TW_MT_DATA_NACK;
+            }
+            scheduleSimulationEvent(HOST_I2C_BYTE_NANOS, &handleTWIOperationComplete, tStatus);
+        }
+    }
+    hostCheckInterrupts();
+}
+
+HostRegister TWCR(0, NULL, &writeTWCR);
+HostRegister TWDR(0xFF);
+HostRegister TWSR(0xF8);
+HostRegister TWBR(0);
+
+/*
+ * The ISRs are defined by the sketch with the ISR() macro
+ */
+extern "C" void USART_RX_vect(void) __attribute__((weak));
+extern "C" void USART_UDRE_vect(void) __attribute__((weak));
+extern "C" void TWI_vect(void) __attribute__((weak));
+
+/*
+ * Calls the ISRs as long as their interrupt is enabled and pending, like the level triggered USART interrupts of the AVR.
+ * Interrupts are disabled while the ISR is running, so no ISR is called by the events processed during an ISR.
+ */
+void hostCheckInterrupts() {
+    while (!sIsInISR && (SREG.Value & _BV(SREG_I))) {
+        void (*tISR)(void);
+        if ((UCSR0B.Value & _BV(RXCIE0)) && (UCSR0A.Value & _BV(RXC0)) && USART_RX_vect != NULL) {
+            tISR = &USART_RX_vect;
+        } else if ((UCSR0B.Value & _BV(UDRIE0)) && (UCSR0A.Value & _BV(UDRE0)) && USART_UDRE_vect != NULL) {
+            tISR = &USART_UDRE_vect;
+        } else if ((TWCR.Value & _BV(TWIE)) && (TWCR.Value & _BV(TWINT)) && TWI_vect != NULL) {
+            tISR = &TWI_vect;
+        } else {
+            return;
+        }
+        sIsInISR = true;
+        SREG.Value &= ~_BV(SREG_I);
+        if (tISR == &TWI_vect) {
+            sHostIOCounters.TWIInterrupts++;
+        } else {
+            sHostIOCounters.USARTInterrupts++;
+        }
+        tISR();
+        advanceSimulationNanos(HOST_ISR_NANOS);
+        SREG.Value |= _BV(SREG_I);
+        sIsInISR = false;
+    }
+}
+
+/*
+ * SoftwareSerialTX is blocking and sends the request to the JK-BMS model
+ */
+SoftwareSerialTX::SoftwareSerialTX(uint8_t transmitPin) {
+    _transmitBitMask = 0;
+    _transmitPortRegister = NULL;
+    _tx_delay = 0;
+    setTX(transmitPin);
+}
+
+void SoftwareSerialTX::setTX(uint8_t transmitPin) {
+    (void) transmitPin;
+}
+
+void SoftwareSerialTX::begin(long speed) {
+    _tx_delay = 16000000L / speed;
+}
+
+/*
+ * Interrupts are disabled while sending one byte
+ */
+size_t SoftwareSerialTX::write(uint8_t b) {
+    uint8_t tSREG = SREG.Value;
+    SREG.Value &= ~_BV(SREG_I);
+    advanceSimulationNanos(HOST_UART_BYTE_NANOS);
+    SREG.Value = tSREG;
+    hostCheckInterrupts();
+    sHostIOCounters.SoftwareSerialTXBytes++;
+    hostJKBMSReceiveRequestByte(b);
+    return 1;
+}
+
+size_t SoftwareSerialTX::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+/*
+ * SPI to the MCP2515
+ */
+SPIClass SPI;
+
+void SPIClass::begin() {
+}
+
+void SPIClass::end() {
+}
+
+void SPIClass::beginTransaction(SPISettings aSettings) {
+    (void) aSettings;
+    advanceSimulationNanos(HOST_SPI_TRANSACTION_NANOS);
+}
+
+void SPIClass::endTransaction() {
+    advanceSimulationNanos(HOST_SPI_TRANSACTION_NANOS);
+}
+
+uint8_t SPIClass::transfer(uint8_t aData) {
+    advanceSimulationNanos(HOST_SPI_BYTE_NANOS);
+    sHostIOCounters.SPIBytes++;
+    return hostMCP2515Transfer(aData);
+}
+
+/*
+ * I2C to the PCF8574 expander of the LCD
+ */
+TwoWire Wire;
+static uint8_t sI2CAddress;
+
+void TwoWire::begin() {
+}
+
+void TwoWire::setClock(uint32_t aClock) {
+    (void) aClock;
+}
+
+void TwoWire::beginTransmission(uint8_t aAddress) {
+    sI2CAddress = aAddress;
+}
+
+size_t TwoWire::write(uint8_t aData) {
+    // Arduino Wire only buffers the data, it is sent by endTransmission(), but timing is the same
+    advanceSimulationNanos(HOST_I2C_BYTE_NANOS);
+    sHostIOCounters.I2CBytes++;
+    sHostIOCounters.I2CWrites++;
+    if (sI2CAddress == HOST_LCD_I2C_ADDRESS && sHostOptions.LCDIsAttached) {
+        hostLCDExpanderWrite(aData);
+    }
+    return 1;
+}
+
+/*
+ * @return 0 for success, 2 for NACK on address
+ */
+uint8_t TwoWire::endTransmission() {
+    // Start, address byte and stop
+    advanceSimulationNanos((2 * HOST_I2C_START_STOP_NANOS) + HOST_I2C_BYTE_NANOS);
+    sHostIOCounters.I2CBytes++;
+    sHostIOCounters.I2CWrites++;
+    if (sI2CAddress == HOST_LCD_I2C_ADDRESS && sHostOptions.LCDIsAttached) {
+        return 0;
+    }
+    return 2;
+}
+
+bool i2c_init(void) {
+    return true;
+}
+
+/*
+ * @return true if slave acknowledged the address
+ */
+bool i2c_start(uint8_t aAddressAndReadBit) {
+    advanceSimulationNanos(HOST_I2C_START_STOP_NANOS + HOST_I2C_BYTE_NANOS);
+    sHostIOCounters.I2CBytes++;
+    sHostIOCounters.I2CWrites++;
+    return (aAddressAndReadBit >> 1) == HOST_LCD_I2C_ADDRESS && sHostOptions.LCDIsAttached;
+}
+
+void i2c_stop(void) {
+    advanceSimulationNanos(HOST_I2C_START_STOP_NANOS);
+}
+
+/*
+ * EasyButton, the press and release is triggered by the simulation
+ */
+static EasyButton *sHostButtonPointer = NULL;
+
+EasyButton::EasyButton(void (*aButtonPressCallback)(bool aButtonToggleState)) {
+    ButtonToggleState = false;
+    ButtonStateIsActive = false;
+    ButtonLastChangeMillis = 0;
+    ButtonPressCallback = aButtonPressCallback;
+    sHostButtonPointer = this;
+}
+
+bool EasyButton::readButtonState() {
+    return ButtonStateIsActive;
+}
+
+bool EasyButton::readDebouncedButtonState() {
+    return ButtonStateIsActive;
+}
+
+uint8_t EasyButton::checkForLongPress(uint16_t aLongPressThresholdMillis) {
+    if (!ButtonStateIsActive) {
+        return EASY_BUTTON_LONG_PRESS_ABORT;
+    }
+    if (millis() - ButtonLastChangeMillis >= aLongPressThresholdMillis) {
+        return EASY_BUTTON_LONG_PRESS_DETECTED;
+    }
+    return EASY_BUTTON_LONG_PRESS_STILL_POSSIBLE;
+}
+
+void hostPressButton() {
+    if (sHostButtonPointer != NULL && !sHostButtonPointer->ButtonStateIsActive) {
+        sHostButtonPointer->ButtonStateIsActive = true;
+        sHostButtonPointer->ButtonToggleState = !sHostButtonPointer->ButtonToggleState;
+        sHostButtonPointer->ButtonLastChangeMillis = millis();
+        if (sHostButtonPointer->ButtonPressCallback != NULL) {
+            sHostButtonPointer->ButtonPressCallback(sHostButtonPointer->ButtonToggleState);
+        }
+    }
+}
+
+void hostReleaseButton() {
+    if (sHostButtonPointer != NULL && sHostButtonPointer->ButtonStateIsActive) {
+        sHostButtonPointer->ButtonStateIsActive = false;
+        sHostButtonPointer->ButtonLastChangeMillis = millis();
+    }
+}
@@ -0,0 +1,422 @@
+/*
+ * HostMain.cpp
+ *
+ * Runs setup() and loop() of JK-BMSToPylontechCAN.ino on a Linux host against the simulated JK-BMS, MCP2515 and LCD
+ * and prints the statistics of the loop passes.
+ *
+ * Each loop pass is assigned to the stage with the highest precedence, for which it did I/O:
+ *  process - found the JK-BMS frame received by the ISR complete, so the frame was processed, printed and CAN data was filled.
+ *  can     - SPI transfers to the MCP2515.
+ *  request - sent the request to the JK-BMS.
+ *  lcd     - wrote to the LCD.
+ *  print   - wrote to Serial.
+ *  isr     - only USART ISRs were running, i.e. bytes were received or sent in the background.
+ *  idle    - nothing of the above.
+ * Virtual time is the time the AVR would need for the I/O of the pass plus HOST_LOOP_PASS_NANOS.
+ * Host time is the time the host CPU needed to execute the pass. It is only an indication of the computing effort.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+#include "HostEasyButton.h"
+#include "SoftwareSerialTX.h"
+
+/*
+ * The frame structures of the sketch rely on the byte alignment of the AVR
+ */
+#pragma pack(push, 1)
+#include "JK-BMSToPylontechCAN.ino"
+#pragma pack(pop)
+
+#define STAGE_SETUP     0
+#define STAGE_PROCESS   1
+#define STAGE_CAN       2
+#define STAGE_REQUEST   3
+#define STAGE_LCD       4
+#define STAGE_PRINT     5
+#define STAGE_ISR       6
+#define STAGE_IDLE      7
+#define NUMBER_OF_STAGES 8
+
+struct LoopStageStatistics {
+    const char *Name;
+    uint32_t Passes;
+    uint64_t VirtualNanosSum;
+    uint64_t VirtualNanosMax;
+    uint64_t HostNanosSum;
+    uint64_t HostNanosMax;
+    uint32_t SerialRXBytes;
+    uint32_t SerialTXWrites;
+    uint32_t SoftwareSerialTXBytes;
+    uint32_t SPIBytes;
+    uint32_t I2CBytes;
+};
+
+LoopStageStatistics sLoopStageStatistics[NUMBER_OF_STAGES] = { { "setup" }, { "process" }, { "can" }, { "request" }, { "lcd" }, {
+        "print" }, { "isr" }, { "idle" } };
+
+static uint64_t getHostNanos() {
+    struct timespec tTime;
+    clock_gettime(CLOCK_MONOTONIC, &tTime);
+    return (uint64_t) tTime.tv_sec * 1000000000 + tTime.tv_nsec;
+}
+
+/*
+ * A frame was processed, if the pass found the requested frame completely received
+ */
+static uint8_t getStageOfPass(const HostIOCounters &aBefore, bool aFrameWasRequested) {
+    if (aFrameWasRequested && !sFrameIsRequested && sJKBMSReceiveStatus == JK_BMS_RECEIVE_FINISHED) {
+        return STAGE_PROCESS;
+    } else if (sHostIOCounters.SPIBytes != aBefore.SPIBytes) {
+        return STAGE_CAN;
+    } else if (sHostIOCounters.SoftwareSerialTXBytes != aBefore.SoftwareSerialTXBytes) {
+        return STAGE_REQUEST;
+    } else if (sHostIOCounters.I2CWrites != aBefore.I2CWrites) {
+        return STAGE_LCD;
+    } else if (sHostIOCounters.SerialTXWrites != aBefore.SerialTXWrites) {
+        return STAGE_PRINT;
+    } else if (sHostIOCounters.USARTInterrupts != aBefore.USARTInterrupts
+            || sHostIOCounters.TWIInterrupts != aBefore.TWIInterrupts) {
+        return STAGE_ISR;
+    }
+    return STAGE_IDLE;
+}
+
+static void addPassToStatistics(uint8_t aStage, const HostIOCounters &aBefore, uint64_t aVirtualNanos, uint64_t aHostNanos) {
+    LoopStageStatistics *tStage = &sLoopStageStatistics[aStage];
+    tStage->Passes++;
+    tStage->VirtualNanosSum += aVirtualNanos;
+    if (tStage->VirtualNanosMax < aVirtualNanos) {
+        tStage->VirtualNanosMax = aVirtualNanos;
+    }
+    tStage->HostNanosSum += aHostNanos;
+    if (tStage->HostNanosMax < aHostNanos) {
+        tStage->HostNanosMax = aHostNanos;
+    }
+    tStage->SerialRXBytes += sHostIOCounters.SerialRXBytesRead - aBefore.SerialRXBytesRead;
+    tStage->SerialTXWrites += sHostIOCounters.SerialTXWrites - aBefore.SerialTXWrites;
+    tStage->SoftwareSerialTXBytes += sHostIOCounters.SoftwareSerialTXBytes - aBefore.SoftwareSerialTXBytes;
+    tStage->SPIBytes += sHostIOCounters.SPIBytes - aBefore.SPIBytes;
+    tStage->I2CBytes += sHostIOCounters.I2CBytes - aBefore.I2CBytes;
+}
+
+/*
+ * Periodic button press
+ */
+static void handleButtonEvent(uintptr_t aIsPress) {
+    if (aIsPress) {
+        hostPressButton();
+        scheduleSimulationEvent((uint64_t) sHostOptions.ButtonPressDurationMillis * 1000000, &handleButtonEvent, false);
+        scheduleSimulationEvent((uint64_t) sHostOptions.ButtonPressPeriodMillis * 1000000, &handleButtonEvent, true);
+    } else {
+        hostReleaseButton();
+    }
+}
+
+static void printStatistics(uint64_t aLoopNanos, uint32_t aNumberOfPasses) {
+    printf("\n");
+    printf("Simulated %.3f s of loop() with %u passes\n", aLoopNanos / 1e9, aNumberOfPasses);
+    printf("Stage    Passes   avg us   max us  host avg ns  host max ns   RX byte   TX byte SWTX byte  SPI byte  I2C byte\n");
+    uint64_t tBusyNanos = 0;
+    for (uint8_t i = 0; i < NUMBER_OF_STAGES; ++i) {
+        LoopStageStatistics *tStage = &sLoopStageStatistics[i];
+        if (tStage->Passes == 0) {
+            continue;
+        }
+        if (i != STAGE_SETUP && i != STAGE_IDLE) {
+            tBusyNanos += tStage->VirtualNanosSum;
+        }
+        printf("%-7s %7u %8.1f %8.1f %12.0f %12.0f %9u %9u %9u %9u %9u\n", tStage->Name, tStage->Passes,
+                tStage->VirtualNanosSum / 1e3 / tStage->Passes, tStage->VirtualNanosMax / 1e3,
+                (double) tStage->HostNanosSum / tStage->Passes, (double) tStage->HostNanosMax, tStage->SerialRXBytes,
+                tStage->SerialTXWrites, tStage->SoftwareSerialTXBytes, tStage->SPIBytes, tStage->I2CBytes);
+    }
+    printf("\n");
+    printf("JK-BMS requests=%u, replies=%u, suppressed replies=%u, frames read=%u, RX overruns=%u\n", getJKBMSRequestCount(),
+            getJKBMSReplyCount(), getJKBMSSuppressedReplyCount(), sHostIOCounters.SerialRXFramesRead,
+            sHostIOCounters.SerialRXOverruns);
+    printf("Serial TX bytes=%u, USART interrupts=%u, TWI interrupts=%u\n", sHostIOCounters.SerialTXBytes,
+            sHostIOCounters.USARTInterrupts, sHostIOCounters.TWIInterrupts);
+    printf("CAN frames requested=%u, sent=%u, retransmissions=%u, aborted=%u\n", sHostIOCounters.CANFramesRequested,
+            sHostIOCounters.CANFramesSent, sHostIOCounters.CANRetransmissions, sHostIOCounters.CANFramesAborted);
+    if (sHostOptions.InverterFramePeriodMillis != 0) {
+        printf("Inverter CAN frames received=%u, rejected=%u, RX overflows=%u, read by sketch=%u, last reply time=%u ms\n",
+                sHostIOCounters.CANFramesReceived, sHostIOCounters.CANFramesRejected, sHostIOCounters.CANRXOverflows,
+                sNumberOfInverterCANFrames, sInverterReplyMillis);
+    }
+    if (getCANLatencyCount() > 0) {
+        printf("Frame to CAN latency avg=%.3f ms, max=%.3f ms, count=%u\n", getCANLatencySum() / 1e6 / getCANLatencyCount(),
+                getCANLatencyMax() / 1e6, getCANLatencyCount());
+    } else {
+        printf("Frame to CAN latency not available\n");
+    }
+    printf("LCD characters=%u, commands=%u, tone calls=%u\n", getLCDCharacterCount(), getLCDCommandCount(),
+            sHostIOCounters.ToneCalls);
+    printf("CPU busy=%.3f %%, headroom=%.3f %%\n", tBusyNanos * 100.0 / aLoopNanos, 100.0 - (tBusyNanos * 100.0 / aLoopNanos));
+}
+
+/*
+ * Feeds aFrame byte by byte to the receive handler of the sketch, like the ISR does.
+ * @return the receive status
+ */
+static uint8_t receiveFrame(const uint8_t *aFrame, size_t aFrameSize) {
+    initJKReplyFrameReceiving();
+    for (size_t i = 0; i < aFrameSize; ++i) {
+        handleJKReplyFrameReceivedByte(aFrame[i]);
+    }
+    return sJKBMSReceiveStatus;
+}
+
+/*
+ * Receives the first log frame aNumberOfRuns times for timing
+ * and then aNumberOfRuns copies of it with randomly mutated token data, to check that decoding never writes out of bounds.
+ * Length and checksum of the mutated frames are corrected, so that they are completely processed by the receive handler.
+ * Use e.g. valgrind or -fsanitize=address to detect writing behind the reply structures.
+ */
+static bool fuzzAndBenchmarkTokenDecoder(uint32_t aNumberOfRuns) {
+    uint16_t tFrameSize;
+    const uint8_t *tFrame = getJKBMSFrame(0, &tFrameSize);
+    size_t tTokenDataIndex = JK_BMS_FRAME_HEADER_LENGTH + 2 + tFrame[JK_BMS_FRAME_INDEX_OF_CELL_INFO_LENGTH];
+    std::vector<uint8_t> tHeader(tFrame, &tFrame[tTokenDataIndex]);
+    std::vector<uint8_t> tTokens(&tFrame[tTokenDataIndex], &tFrame[tFrameSize - JK_BMS_FRAME_TRAILER_LENGTH]);
+    std::vector<uint8_t> tTrailer(&tFrame[tFrameSize - JK_BMS_FRAME_TRAILER_LENGTH], &tFrame[tFrameSize]);
+
+    uint64_t tHostStartNanos = getHostNanos();
+    uint32_t tErrors = 0;
+    for (uint32_t i = 0; i < aNumberOfRuns; ++i) {
+        if (receiveFrame(tFrame, tFrameSize) != JK_BMS_RECEIVE_FINISHED || sJKBMSTokenErrorIndex != 0) {
+            tErrors++;
+        }
+    }
+    uint64_t tHostNanos = getHostNanos() - tHostStartNanos;
+    printf("Received %u bytes of frame with %zu bytes of tokens %u times, avg %.0f host ns, errors=%u\n", tFrameSize,
+            tTokens.size(), aNumberOfRuns, (double) tHostNanos / aNumberOfRuns, tErrors);
+    if (tErrors != 0) {
+        return false;
+    }
+
+    /*
+     * Computation of the values which are converted to CAN data, which uses float or fixed point, see USE_FIXED_POINT
+     */
+    useReceivedJKReply();
+    fillJKConvertedCellInfo();
+    tHostStartNanos = getHostNanos();
+    for (uint32_t i = 0; i < aNumberOfRuns; ++i) {
+        fillJKComputedData();
+        PylontechCANSohSocFrame.fillFrame(sJKFAllReplyPointer);
+    }
+    tHostNanos = getHostNanos() - tHostStartNanos;
+#if defined(USE_FIXED_POINT)
+    printf("Computed data with fixed point %u times, avg %.0f host ns, power=%d W\n", aNumberOfRuns,
+            (double) tHostNanos / aNumberOfRuns, JKComputedData.BatteryLoadPower);
+#else
+    printf("Computed data with float %u times, avg %.0f host ns, power=%d W\n", aNumberOfRuns, (double) tHostNanos / aNumberOfRuns,
+            JKComputedData.BatteryLoadPower);
+#endif
+
+    srand(1);
+    uint32_t tCompletelyDecoded = 0;
+    for (uint32_t i = 0; i < aNumberOfRuns; ++i) {
+        std::vector<uint8_t> tMutatedTokens = tTokens;
+        uint8_t tNumberOfMutations = 1 + rand() % 4;
+        for (uint8_t j = 0; j < tNumberOfMutations && !tMutatedTokens.empty(); ++j) {
+            size_t tIndex = rand() % tMutatedTokens.size();
+            switch (rand() % 4) {
+            case 0:
+                tMutatedTokens[tIndex] = rand();
+                break;
+            case 1:
+                tMutatedTokens.insert(tMutatedTokens.begin() + tIndex, (uint8_t) rand());
+                break;
+            case 2:
+                tMutatedTokens.erase(tMutatedTokens.begin() + tIndex);
+                break;
+            default:
+                tMutatedTokens.resize(tIndex);
+                break;
+            }
+        }
+        std::vector<uint8_t> tMutatedFrame = tHeader;
+        tMutatedFrame.insert(tMutatedFrame.end(), tMutatedTokens.begin(), tMutatedTokens.end());
+        tMutatedFrame.insert(tMutatedFrame.end(), tTrailer.begin(), tTrailer.end());
+        uint16_t tLength = tMutatedFrame.size() - 2;
+        tMutatedFrame[2] = tLength >> 8;
+        tMutatedFrame[3] = tLength;
+        uint16_t tChecksum = 0;
+        for (uint16_t j = 0; j < tLength - 2; ++j) {
+            tChecksum += tMutatedFrame[j];
+        }
+        tMutatedFrame[tLength] = tChecksum >> 8;
+        tMutatedFrame[tLength + 1] = tChecksum;
+
+        if (receiveFrame(tMutatedFrame.data(), tMutatedFrame.size()) != JK_BMS_RECEIVE_FINISHED) {
+            printf("Fuzz run %u: frame was not received\n", i);
+            tErrors++;
+        } else if (sJKBMSTokenErrorIndex == 0) {
+            tCompletelyDecoded++;
+            useReceivedJKReply();
+        } else if (sJKBMSTokenErrorIndex < tTokenDataIndex || sJKBMSTokenErrorIndex > tLength + 2 - JK_BMS_FRAME_TRAILER_LENGTH) {
+            printf("Fuzz run %u: decoding stopped outside of token data\n", i);
+            tErrors++;
+        }
+    }
+    printf("Received %u frames with mutated token data, completely decoded=%u, errors=%u\n", aNumberOfRuns,
+            tCompletelyDecoded, tErrors);
+    return tErrors == 0;
+}
+
+static void printUsage(const char *aProgramName) {
+    fprintf(stderr, "Usage: %s [options]\n", aProgramName);
+    fprintf(stderr, " -f <file>    Log file with JK-BMS frames, default ../JK-BMS.log\n");
+    fprintf(stderr, " -t <seconds> Seconds to simulate after setup(), default 60\n");
+    fprintf(stderr, " -s <scale>   Add host CPU time multiplied by scale to virtual time, default 0\n");
+    fprintf(stderr, " -m <n>       JK-BMS does not reply to every nth request\n");
+    fprintf(stderr, " -p <n>       JK-BMS changes its charge overcurrent protection every n replies\n");
+    fprintf(stderr, " -b <millis>  Press button every <millis>\n");
+    fprintf(stderr, " -d <millis>  Duration of button press, default 100\n");
+    fprintf(stderr, " -v           Vary current and cell voltages of JK-BMS frames\n");
+    fprintf(stderr, " -a           No CAN receiver, frames are not acknowledged\n");
+    fprintf(stderr, " -i <millis>  Inverter sends a 0x305 frame every <millis>\n");
+    fprintf(stderr, " -n           No LCD connected\n");
+    fprintf(stderr, " -o           Print Serial output of the sketch\n");
+    fprintf(stderr, " -c           Print sent CAN frames\n");
+    fprintf(stderr, " -l           Print LCD content at end of simulation\n");
+    fprintf(stderr, " -z <n>       Do not simulate, but benchmark and fuzz the frame receive handler with n runs\n");
+    fprintf(stderr, " -h           Print this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *tFilename = "../JK-BMS.log";
+    sHostOptions.LCDIsAttached = true;
+    sHostOptions.CANIsAcknowledged = true;
+    sHostOptions.ButtonPressDurationMillis = 100;
+    sHostOptions.SimulationSeconds = 60;
+    uint32_t tNumberOfDecoderRuns = 0;
+
+    int tOption;
+    while ((tOption = getopt(argc, argv, "f:t:s:m:p:b:d:i:vanoclz:h")) != -1) {
+        switch (tOption) {
+        case 'f':
+            tFilename = optarg;
+            break;
+        case 't':
+            sHostOptions.SimulationSeconds = strtoul(optarg, NULL, 10);
+            break;
+        case 's':
+            sHostOptions.HostTimeScale = strtod(optarg, NULL);
+            break;
+        case 'm':
+            sHostOptions.TimeoutEveryNthRequest = strtoul(optarg, NULL, 10);
+            break;
+        case 'p':
+            sHostOptions.ConfigurationChangePeriod = strtoul(optarg, NULL, 10);
+            break;
+        case 'b':
+            sHostOptions.ButtonPressPeriodMillis = strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            sHostOptions.ButtonPressDurationMillis = strtoul(optarg, NULL, 10);
+            break;
+        case 'i':
+            sHostOptions.InverterFramePeriodMillis = strtoul(optarg, NULL, 10);
+            break;
+        case 'v':
+            sHostOptions.VaryJKData = true;
+            break;
+        case 'a':
+            sHostOptions.CANIsAcknowledged = false;
+            break;
+        case 'n':
+            sHostOptions.LCDIsAttached = false;
+            break;
+        case 'o':
+            sHostOptions.PrintSerialOutput = true;
+            break;
+        case 'c':
+            sHostOptions.PrintCANFrames = true;
+            break;
+        case 'l':
+            sHostOptions.DumpLCD = true;
+            break;
+        case 'z':
+            tNumberOfDecoderRuns = strtoul(optarg, NULL, 10);
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return 0;
+        default:
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!readJKBMSLogFile(tFilename)) {
+        fprintf(stderr, "No JK-BMS frame found in %s\n", tFilename);
+        return 1;
+    }
+    printf("%u JK-BMS frames read from %s\n", getNumberOfJKBMSFrames(), tFilename);
+    if (tNumberOfDecoderRuns != 0) {
+        return fuzzAndBenchmarkTokenDecoder(tNumberOfDecoderRuns) ? 0 : 1;
+    }
+    hostSetCANChipSelectPin(SPI_CS_PIN);
+
+    HostIOCounters tCountersBefore = sHostIOCounters;
+    uint64_t tVirtualStartNanos = getSimulationNanos();
+    uint64_t tHostStartNanos = getHostNanos();
+    setup();
+    addPassToStatistics(STAGE_SETUP, tCountersBefore, getSimulationNanos() - tVirtualStartNanos,
+            getHostNanos() - tHostStartNanos);
+
+    if (sHostOptions.ButtonPressPeriodMillis != 0) {
+        scheduleSimulationEvent((uint64_t) sHostOptions.ButtonPressPeriodMillis * 1000000, &handleButtonEvent, true);
+    }
+    if (sHostOptions.InverterFramePeriodMillis != 0) {
+        startInverterCANFrames();
+    }
+
+    uint64_t tLoopStartNanos = getSimulationNanos();
+    uint64_t tLoopEndNanos = tLoopStartNanos + (uint64_t) sHostOptions.SimulationSeconds * 1000000000;
+    uint32_t tNumberOfPasses = 0;
+    while (getSimulationNanos() < tLoopEndNanos) {
+        tCountersBefore = sHostIOCounters;
+        tVirtualStartNanos = getSimulationNanos();
+        tHostStartNanos = getHostNanos();
+        bool tFrameWasRequested = sFrameIsRequested;
+        loop();
+        uint64_t tHostNanos = getHostNanos() - tHostStartNanos;
+        advanceSimulationNanos(HOST_LOOP_PASS_NANOS + (uint64_t) (tHostNanos * sHostOptions.HostTimeScale));
+        addPassToStatistics(getStageOfPass(tCountersBefore, tFrameWasRequested), tCountersBefore, getSimulationNanos() - tVirtualStartNanos,
+                tHostNanos);
+        tNumberOfPasses++;
+    }
+
+    fflush(stdout);
+    printStatistics(getSimulationNanos() - tLoopStartNanos, tNumberOfPasses);
+    if (sHostOptions.DumpLCD) {
+        printHostLCDScreen();
+    }
+    return 0;
+}
@@ -0,0 +1,763 @@
+/*
+ * HostPeripherals.cpp
+ *
+ * Models of the peripherals connected to the Arduino running JK-BMSToPylontechCAN.ino.
+ *
+ * JK-BMS:  Receives the request from SoftwareSerialTX and replies with the next frame read from a log file,
+ *          like extras/JK-BMS.log, byte by byte at 115200 baud to the Serial RX buffer.
+ * MCP2515: Register and SPI instruction model with 3 TX buffers, TX priority and the 500 kBit/s frame duration.
+ *          2 RX buffers with acceptance filters and rollover receive the 0x305 frames of a simulated inverter.
+ * LCD:     PCF8574 I2C expander connected to a HD44780 2004 LCD in 4 bit mode, with DDRAM and CGRAM.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#include <vector>
+
+#include <Arduino.h>
+#include "mcp2515_can_dfs.h"
+
+/**************************************************
+ * JK-BMS
+ **************************************************/
+#define JK_BMS_INDEX_OF_CELL_INFO_LENGTH    12
+#define JK_BMS_TOKEN_CURRENT                0x84
+#define JK_BMS_TOKEN_CHARGE_OVERCURRENT     0x99
+
+static std::vector<std::vector<uint8_t> > sJKBMSFrames;
+static std::vector<uint8_t> sJKBMSReplyFrame;   // The frame which is currently sent
+static uint32_t sJKBMSReplyGeneration = 0;      // To discard the remaining bytes of an old reply at a new request
+static uint8_t sJKBMSRequestBuffer[32];
+static uint8_t sJKBMSRequestIndex = 0;
+static uint32_t sJKBMSRequestCount = 0;
+static uint32_t sJKBMSReplyCount = 0;
+static uint32_t sJKBMSSuppressedReplyCount = 0;
+static uint64_t sJKBMSNanosOfLastFrameEnd = 0;
+
+static void setJKBMSFrameChecksum(std::vector<uint8_t> &aFrame) {
+    uint16_t tFrameLength = (aFrame[2] << 8) + aFrame[3];
+    uint16_t tChecksum = 0;
+    for (uint16_t i = 0; i < tFrameLength - 2; i++) {
+        tChecksum += aFrame[i];
+    }
+    aFrame[tFrameLength] = tChecksum >> 8;
+    aFrame[tFrameLength + 1] = tChecksum;
+}
+
+static void addJKBMSFrame(std::vector<uint8_t> &aFrame) {
+    if (aFrame.empty()) {
+        return;
+    }
+    if (aFrame.size() < 20 || aFrame[0] != 0x4E || aFrame[1] != 0x57
+            || aFrame.size() != (size_t) ((aFrame[2] << 8) + aFrame[3] + 2)) {
+        fprintf(stderr, "Skip %zu bytes, which are no valid JK-BMS reply frame\n", aFrame.size());
+    } else {
+        sJKBMSFrames.push_back(aFrame);
+    }
+    aFrame.clear();
+}
+
+/*
+ * Reads all frames of a hex dump log like ../JK-BMS.log.
+ * Each frame line starts with the address, followed by the data bytes, all in 0x format.
+ * Every other line terminates the frame.
+ */
+bool readJKBMSLogFile(const char *aFilename) {
+    FILE *tFile = fopen(aFilename, "r");
+    if (tFile == NULL) {
+        perror(aFilename);
+        return false;
+    }
+    char tLine[512];
+    std::vector<uint8_t> tFrame;
+    while (fgets(tLine, sizeof(tLine), tFile) != NULL) {
+        bool tIsFrameLine = true;
+        bool tIsAddress = true;
+        std::vector<uint8_t> tBytesOfLine;
+        for (char *tToken = strtok(tLine, " \t\r\n"); tToken != NULL; tToken = strtok(NULL, " \t\r\n")) {
+            char *tEnd;
+            unsigned long tValue = strtoul(tToken, &tEnd, 16);
+            if (strncmp(tToken, "0x", 2) != 0 || *tEnd != '\0' || (!tIsAddress && tValue > 0xFF)) {
+                tIsFrameLine = false;
+                break;
+            }
+            if (!tIsAddress) {
+                tBytesOfLine.push_back(tValue);
+            }
+            tIsAddress = false;
+        }
+        if (tIsFrameLine && !tIsAddress) {
+            tFrame.insert(tFrame.end(), tBytesOfLine.begin(), tBytesOfLine.end());
+        } else {
+            addJKBMSFrame(tFrame);
+        }
+    }
+    addJKBMSFrame(tFrame);
+    fclose(tFile);
+    return !sJKBMSFrames.empty();
+}
+
+uint16_t getNumberOfJKBMSFrames() {
+    return sJKBMSFrames.size();
+}
+
+const uint8_t* getJKBMSFrame(uint16_t aFrameIndex, uint16_t *aFrameSize) {
+    *aFrameSize = sJKBMSFrames[aFrameIndex].size();
+    return sJKBMSFrames[aFrameIndex].data();
+}
+
+/*
+ * Modify current and cell voltages, to get changing data on CAN and LCD
+ */
+static void varyJKBMSFrame(std::vector<uint8_t> &aFrame, uint32_t aCount) {
+    uint8_t tCellInfoLength = aFrame[JK_BMS_INDEX_OF_CELL_INFO_LENGTH];
+    for (uint8_t i = 0; i < tCellInfoLength / 3; ++i) {
+        uint16_t tIndex = JK_BMS_INDEX_OF_CELL_INFO_LENGTH + 1 + (i * 3) + 1;
+        uint16_t tCellMillivolt = (aFrame[tIndex] << 8) + aFrame[tIndex + 1];
+        tCellMillivolt += ((aCount * 7 + i * 13) % 21) - 10;
+        aFrame[tIndex] = tCellMillivolt >> 8;
+        aFrame[tIndex + 1] = tCellMillivolt;
+    }
+    // Current token is the 5th token after the cell info, each token has 2 bytes value
+    uint16_t tCurrentIndex = JK_BMS_INDEX_OF_CELL_INFO_LENGTH + 1 + tCellInfoLength + (4 * 3);
+    if (aFrame[tCurrentIndex] == JK_BMS_TOKEN_CURRENT) {
+        // 10 mA resolution, bit 15 set means charging
+        int16_t tCurrent10Milliampere = 2000 * sin(aCount * 0.3);
+        uint16_t tRawCurrent = (tCurrent10Milliampere >= 0) ? (0x8000 | tCurrent10Milliampere) : -tCurrent10Milliampere;
+        aFrame[tCurrentIndex + 1] = tRawCurrent >> 8;
+        aFrame[tCurrentIndex + 2] = tRawCurrent;
+    }
+    setJKBMSFrameChecksum(aFrame);
+}
+
+/*
+ * Toggle the charge overcurrent protection between its value and value + 10 A every aPeriod replies,
+ * like a user changing the BMS configuration with the app
+ */
+static void changeJKBMSConfiguration(std::vector<uint8_t> &aFrame, uint32_t aCount, uint32_t aPeriod) {
+    if (((aCount / aPeriod) & 1) == 0) {
+        return;
+    }
+    // Token 0x99 is located between 0x98 and 0x9A, all with 2 bytes value
+    for (size_t i = 3; i + 3 < aFrame.size(); ++i) {
+        if (aFrame[i] == JK_BMS_TOKEN_CHARGE_OVERCURRENT && aFrame[i - 3] == JK_BMS_TOKEN_CHARGE_OVERCURRENT - 1
+                && aFrame[i + 3] == JK_BMS_TOKEN_CHARGE_OVERCURRENT + 1) {
+            uint16_t tAmpere = (aFrame[i + 1] << 8) + aFrame[i + 2] + 10;
+            aFrame[i + 1] = tAmpere >> 8;
+            aFrame[i + 2] = tAmpere;
+            setJKBMSFrameChecksum(aFrame);
+            return;
+        }
+    }
+}
+
+static void sendNextJKBMSReplyByte(uintptr_t aParameter) {
+    uint32_t tGeneration = aParameter >> 16;
+    uint16_t tIndex = aParameter & 0xFFFF;
+    if (tGeneration != (sJKBMSReplyGeneration & 0xFFFF)) {
+        return; // Reply was aborted by a new request
+    }
+    bool tIsLastByte = (tIndex == sJKBMSReplyFrame.size() - 1);
+    hostSerialReceiveByte(sJKBMSReplyFrame[tIndex], tIsLastByte);
+    if (tIsLastByte) {
+        sJKBMSNanosOfLastFrameEnd = getSimulationNanos();
+    } else {
+        scheduleSimulationEvent(HOST_UART_BYTE_NANOS, &sendNextJKBMSReplyByte, aParameter + 1);
+    }
+}
+
+static void handleJKBMSRequest() {
+    sJKBMSRequestCount++;
+    sJKBMSReplyGeneration++;
+    if (sHostOptions.TimeoutEveryNthRequest != 0 && (sJKBMSRequestCount % sHostOptions.TimeoutEveryNthRequest) == 0) {
+        sJKBMSSuppressedReplyCount++;
+        return;
+    }
+    sJKBMSReplyFrame = sJKBMSFrames[sJKBMSReplyCount % sJKBMSFrames.size()];
+    if (sHostOptions.VaryJKData) {
+        varyJKBMSFrame(sJKBMSReplyFrame, sJKBMSReplyCount);
+    }
+    if (sHostOptions.ConfigurationChangePeriod != 0) {
+        changeJKBMSConfiguration(sJKBMSReplyFrame, sJKBMSReplyCount, sHostOptions.ConfigurationChangePeriod);
+    }
+    sJKBMSReplyCount++;
+    // The first byte is received one byte time after the reply started
+    scheduleSimulationEvent(HOST_JK_BMS_REPLY_DELAY_NANOS + HOST_UART_BYTE_NANOS, &sendNextJKBMSReplyByte,
+            (uintptr_t) (sJKBMSReplyGeneration & 0xFFFF) << 16);
+}
+
+/*
+ * Collects the bytes of the request frame and replies if request is complete
+ */
+void hostJKBMSReceiveRequestByte(uint8_t aByte) {
+    if (sJKBMSRequestIndex == 0 && aByte != 0x4E) {
+        return; // Wait for start of frame
+    }
+    sJKBMSRequestBuffer[sJKBMSRequestIndex++] = aByte;
+    if (sJKBMSRequestIndex >= 4) {
+        uint16_t tRequestLength = (sJKBMSRequestBuffer[2] << 8) + sJKBMSRequestBuffer[3] + 2;
+        if (tRequestLength > sizeof(sJKBMSRequestBuffer)) {
+            sJKBMSRequestIndex = 0;
+        } else if (sJKBMSRequestIndex == tRequestLength) {
+            sJKBMSRequestIndex = 0;
+            handleJKBMSRequest();
+        }
+    }
+}
+
+uint32_t getJKBMSRequestCount() {
+    return sJKBMSRequestCount;
+}
+uint32_t getJKBMSReplyCount() {
+    return sJKBMSReplyCount;
+}
+uint32_t getJKBMSSuppressedReplyCount() {
+    return sJKBMSSuppressedReplyCount;
+}
+uint64_t getJKBMSNanosOfLastFrameEnd() {
+    return sJKBMSNanosOfLastFrameEnd;
+}
+
+/**************************************************
+ * MCP2515
+ **************************************************/
+#define MCP2515_NUMBER_OF_TX_BUFFERS    3
+#define MCP2515_FRAME_ID_FOR_LATENCY    0x356 // Current values frame is taken for the frame to CAN latency
+
+#define MCP2515_STATE_INSTRUCTION       0
+#define MCP2515_STATE_ADDRESS           1
+#define MCP2515_STATE_READ              2
+#define MCP2515_STATE_WRITE             3
+#define MCP2515_STATE_BITMOD_ADDRESS    4
+#define MCP2515_STATE_BITMOD_MASK       5
+#define MCP2515_STATE_BITMOD_DATA       6
+#define MCP2515_STATE_READ_STATUS       7
+#define MCP2515_STATE_RX_STATUS         8
+#define MCP2515_STATE_IGNORE            9
+
+static uint8_t sMCP2515Registers[128];
+static bool sMCP2515IsSelected = false;
+static uint8_t sMCP2515State = MCP2515_STATE_INSTRUCTION;
+static uint8_t sMCP2515Instruction;
+static uint8_t sMCP2515Address;
+static uint8_t sMCP2515BitModMask;
+static uint8_t sMCP2515RXBufferToClear = 0;                     // RXnIF flag to clear after READ RX BUFFER
+static int8_t sMCP2515BufferInTransmission = -1;
+static uint32_t sMCP2515TransmissionGeneration = 0;
+static uint64_t sMCP2515RequestNanos[MCP2515_NUMBER_OF_TX_BUFFERS];
+static uint64_t sCANLatencyAccountedFrameEndNanos = 0;
+static uint64_t sCANLatencySum = 0;
+static uint64_t sCANLatencyMax = 0;
+static uint32_t sCANLatencyCount = 0;
+
+static uint8_t getTXBufferControlAddress(uint8_t aBufferIndex) {
+    return MCP_TXB0CTRL + (aBufferIndex * 0x10);
+}
+
+static void resetMCP2515Model() {
+    memset(sMCP2515Registers, 0, sizeof(sMCP2515Registers));
+    sMCP2515Registers[MCP_CANCTRL] = 0x87;
+    sMCP2515BufferInTransmission = -1;
+    sMCP2515TransmissionGeneration++;
+}
+
+static void startNextCANTransmission();
+
+static void handleCANTransmissionEnd(uintptr_t aGeneration) {
+    if (aGeneration != sMCP2515TransmissionGeneration || sMCP2515BufferInTransmission < 0) {
+        return; // aborted
+    }
+    uint8_t tBufferIndex = sMCP2515BufferInTransmission;
+    uint8_t tControlAddress = getTXBufferControlAddress(tBufferIndex);
+    sMCP2515BufferInTransmission = -1;
+
+    if (!sHostOptions.CANIsAcknowledged) {
+        // No receiver on bus -> ACK error, frame is retransmitted until abort
+        sMCP2515Registers[tControlAddress] |= MCP_TXB_TXERR_M;
+        sHostIOCounters.CANRetransmissions++;
+        if (sMCP2515Registers[MCP_CANCTRL] & 0x08) {
+            // One shot mode
+            sMCP2515Registers[tControlAddress] &= ~MCP_TXB_TXREQ_M;
+        }
+    } else {
+        sMCP2515Registers[tControlAddress] &= ~(MCP_TXB_TXREQ_M | MCP_TXB_TXERR_M);
+        sMCP2515Registers[MCP_CANINTF] |= (MCP_TX0IF << tBufferIndex);
+        sHostIOCounters.CANFramesSent++;
+
+        uint16_t tCANId = (sMCP2515Registers[tControlAddress + 1] << 3) | (sMCP2515Registers[tControlAddress + 2] >> 5);
+        uint8_t tDLC = sMCP2515Registers[tControlAddress + 5] & 0x0F;
+        if (tDLC > 8) {
+            tDLC = 8;
+        }
+        if (sHostOptions.PrintCANFrames) {
+            printf("%10.6f CAN 0x%03X [%u]", getSimulationNanos() / 1e9, tCANId, tDLC);
+            for (uint8_t i = 0; i < tDLC; ++i) {
+                printf(" %02X", sMCP2515Registers[tControlAddress + 6 + i]);
+            }
+            printf("\n");
+        }
+
+        /*
+         * Latency from end of reception of JK-BMS frame to end of the first transmission of data requested after this frame
+         */
+        uint64_t tFrameEndNanos = getJKBMSNanosOfLastFrameEnd();
+        if (tCANId == MCP2515_FRAME_ID_FOR_LATENCY && tFrameEndNanos > sCANLatencyAccountedFrameEndNanos
+                && sMCP2515RequestNanos[tBufferIndex] >= tFrameEndNanos) {
+            uint64_t tLatency = getSimulationNanos() - tFrameEndNanos;
+            sCANLatencyAccountedFrameEndNanos = tFrameEndNanos;
+            sCANLatencySum += tLatency;
+            sCANLatencyCount++;
+            if (sCANLatencyMax < tLatency) {
+                sCANLatencyMax = tLatency;
+            }
+        }
+    }
+    startNextCANTransmission();
+}
+
+/*
+ * Start transmission of buffer with highest priority. For the same priority, the higher buffer number is sent first.
+ */
+static void startNextCANTransmission() {
+    uint8_t tMode = sMCP2515Registers[MCP_CANCTRL] & MODE_MASK;
+    if (sMCP2515BufferInTransmission >= 0 || tMode != MODE_NORMAL) {
+        return;
+    }
+    int8_t tBestBuffer = -1;
+    uint8_t tBestPriority = 0;
+    for (uint8_t i = 0; i < MCP2515_NUMBER_OF_TX_BUFFERS; ++i) {
+        uint8_t tControl = sMCP2515Registers[getTXBufferControlAddress(i)];
+        if ((tControl & MCP_TXB_TXREQ_M) && (tBestBuffer < 0 || (tControl & MCP_TXB_TXP10_M) >= tBestPriority)) {
+            tBestBuffer = i;
+            tBestPriority = tControl & MCP_TXB_TXP10_M;
+        }
+    }
+    if (tBestBuffer < 0) {
+        return;
+    }
+    uint8_t tDLC = sMCP2515Registers[getTXBufferControlAddress(tBestBuffer) + 5] & 0x0F;
+    if (tDLC > 8) {
+        tDLC = 8;
+    }
+    // 44 bit frame overhead + 3 bit interframe space + data + approximately 10 % stuff bits
+    uint16_t tBits = 47 + (8 * tDLC);
+    tBits += (tBits - 10) / 10;
+    sMCP2515BufferInTransmission = tBestBuffer;
+    sMCP2515TransmissionGeneration++;
+    scheduleSimulationEvent((uint64_t) tBits * HOST_CAN_BIT_NANOS, &handleCANTransmissionEnd, sMCP2515TransmissionGeneration);
+}
+
+static void requestCANTransmission(uint8_t aBufferIndex) {
+    uint8_t tControlAddress = getTXBufferControlAddress(aBufferIndex);
+    sMCP2515Registers[tControlAddress] |= MCP_TXB_TXREQ_M;
+    sMCP2515Registers[tControlAddress] &= ~(MCP_TXB_ABTF_M | MCP_TXB_MLOA_M | MCP_TXB_TXERR_M);
+    sMCP2515RequestNanos[aBufferIndex] = getSimulationNanos();
+    sHostIOCounters.CANFramesRequested++;
+    startNextCANTransmission();
+}
+
+static void abortAllCANTransmissions() {
+    for (uint8_t i = 0; i < MCP2515_NUMBER_OF_TX_BUFFERS; ++i) {
+        uint8_t tControlAddress = getTXBufferControlAddress(i);
+        if (sMCP2515Registers[tControlAddress] & MCP_TXB_TXREQ_M) {
+            sMCP2515Registers[tControlAddress] &= ~MCP_TXB_TXREQ_M;
+            sMCP2515Registers[tControlAddress] |= MCP_TXB_ABTF_M;
+            sHostIOCounters.CANFramesAborted++;
+        }
+    }
+    sMCP2515BufferInTransmission = -1;
+    sMCP2515TransmissionGeneration++;
+}
+
+static void writeMCP2515ModelRegister(uint8_t aAddress, uint8_t aValue) {
+    aAddress &= 0x7F;
+    uint8_t tOldValue = sMCP2515Registers[aAddress];
+    if ((aAddress & 0x0F) == 0x0E) {
+        return; // CANSTAT is read only
+    }
+    if (aAddress == MCP_TXB0CTRL || aAddress == MCP_TXB1CTRL || aAddress == MCP_TXB2CTRL) {
+        // Only TXREQ and priority are writable
+        uint8_t tBufferIndex = (aAddress - MCP_TXB0CTRL) >> 4;
+        sMCP2515Registers[aAddress] = (tOldValue & ~(MCP_TXB_TXREQ_M | MCP_TXB_TXP10_M))
+                | (aValue & (MCP_TXB_TXREQ_M | MCP_TXB_TXP10_M));
+        if ((aValue & MCP_TXB_TXREQ_M) && !(tOldValue & MCP_TXB_TXREQ_M)) {
+            sMCP2515Registers[aAddress] = (tOldValue & ~MCP_TXB_TXP10_M) | (aValue & MCP_TXB_TXP10_M);
+            requestCANTransmission(tBufferIndex);
+        }
+        return;
+    }
+    sMCP2515Registers[aAddress] = aValue;
+    if ((aAddress & 0x0F) == 0x0F) {
+        // CANCTRL and its mirrors
+        sMCP2515Registers[MCP_CANCTRL] = aValue;
+        if (aValue & ABORT_TX) {
+            abortAllCANTransmissions();
+        }
+        startNextCANTransmission();
+    }
+}
+
+static uint8_t readMCP2515ModelRegister(uint8_t aAddress) {
+    aAddress &= 0x7F;
+    if ((aAddress & 0x0F) == 0x0E) {
+        // CANSTAT, operation mode is always the requested mode
+        return sMCP2515Registers[MCP_CANCTRL] & MODE_MASK;
+    }
+    if ((aAddress & 0x0F) == 0x0F) {
+        return sMCP2515Registers[MCP_CANCTRL];
+    }
+    return sMCP2515Registers[aAddress];
+}
+
+static uint8_t getMCP2515ReadStatus() {
+    uint8_t tIntFlags = sMCP2515Registers[MCP_CANINTF];
+    uint8_t tStatus = tIntFlags & (MCP_RX0IF | MCP_RX1IF);
+    for (uint8_t i = 0; i < MCP2515_NUMBER_OF_TX_BUFFERS; ++i) {
+        if (sMCP2515Registers[getTXBufferControlAddress(i)] & MCP_TXB_TXREQ_M) {
+            tStatus |= 0x04 << (2 * i);
+        }
+        if (tIntFlags & (MCP_TX0IF << i)) {
+            tStatus |= 0x08 << (2 * i);
+        }
+    }
+    return tStatus;
+}
+
+void hostMCP2515SetChipSelect(bool aIsSelected) {
+    if (!aIsSelected && sMCP2515IsSelected && sMCP2515RXBufferToClear != 0) {
+        sMCP2515Registers[MCP_CANINTF] &= ~sMCP2515RXBufferToClear;
+        sMCP2515RXBufferToClear = 0;
+    }
+    sMCP2515IsSelected = aIsSelected;
+    sMCP2515State = MCP2515_STATE_INSTRUCTION;
+}
+
+uint8_t hostMCP2515Transfer(uint8_t aByte) {
+    if (!sMCP2515IsSelected) {
+        return 0xFF;
+    }
+    uint8_t tReturnValue = 0xFF;
+    switch (sMCP2515State) {
+    case MCP2515_STATE_INSTRUCTION:
+        sMCP2515Instruction = aByte;
+        if (aByte == MCP_RESET) {
+            resetMCP2515Model();
+            sMCP2515State = MCP2515_STATE_IGNORE;
+        } else if (aByte == MCP_READ || aByte == MCP_WRITE) {
+            sMCP2515State = MCP2515_STATE_ADDRESS;
+        } else if (aByte == MCP_BITMOD) {
+            sMCP2515State = MCP2515_STATE_BITMOD_ADDRESS;
+        } else if (aByte >= MCP_LOAD_TX0 && aByte <= MCP_LOAD_TX0 + 5) {
+            // 0x40 -> TXB0SIDH, 0x41 -> TXB0D0, 0x42 -> TXB1SIDH ...
+            uint8_t tOffset = aByte - MCP_LOAD_TX0;
+            sMCP2515Address = getTXBufferControlAddress(tOffset >> 1) + ((tOffset & 0x01) ? 6 : 1);
+            sMCP2515State = MCP2515_STATE_WRITE;
+        } else if ((aByte & 0xF8) == 0x80) {
+            for (uint8_t i = 0; i < MCP2515_NUMBER_OF_TX_BUFFERS; ++i) {
+                if (aByte & (1 << i)) {
+                    requestCANTransmission(i);
+                }
+            }
+            sMCP2515State = MCP2515_STATE_IGNORE;
+        } else if ((aByte & 0xF9) == 0x90) {
+            // READ RX BUFFER 0x90 -> RXB0SIDH, 0x92 -> RXB0D0, 0x94 -> RXB1SIDH, 0x96 -> RXB1D0
+            uint8_t tBufferIndex = (aByte >> 2) & 0x01;
+            sMCP2515Address = MCP_RXB0CTRL + (tBufferIndex * 0x10) + ((aByte & 0x02) ? 6 : 1);
+            sMCP2515RXBufferToClear = MCP_RX0IF << tBufferIndex;
+            sMCP2515State = MCP2515_STATE_READ;
+        } else if (aByte == MCP_READ_STATUS) {
+            sMCP2515State = MCP2515_STATE_READ_STATUS;
+        } else if (aByte == MCP_RX_STATUS) {
+            sMCP2515State = MCP2515_STATE_RX_STATUS;
+        } else {
+            sMCP2515State = MCP2515_STATE_IGNORE;
+        }
+        break;
+
+    case MCP2515_STATE_ADDRESS:
+        sMCP2515Address = aByte;
+        sMCP2515State = (sMCP2515Instruction == MCP_READ) ? MCP2515_STATE_READ : MCP2515_STATE_WRITE;
+        break;
+
+    case MCP2515_STATE_READ:
+        tReturnValue = readMCP2515ModelRegister(sMCP2515Address++);
+        break;
+
+    case MCP2515_STATE_WRITE:
+        writeMCP2515ModelRegister(sMCP2515Address++, aByte);
+        break;
+
+    case MCP2515_STATE_BITMOD_ADDRESS:
+        sMCP2515Address = aByte;
+        sMCP2515State = MCP2515_STATE_BITMOD_MASK;
+        break;
+
+    case MCP2515_STATE_BITMOD_MASK:
+        sMCP2515BitModMask = aByte;
+        sMCP2515State = MCP2515_STATE_BITMOD_DATA;
+        break;
+
+    case MCP2515_STATE_BITMOD_DATA:
+        writeMCP2515ModelRegister(sMCP2515Address,
+                (readMCP2515ModelRegister(sMCP2515Address) & ~sMCP2515BitModMask) | (aByte & sMCP2515BitModMask));
+        sMCP2515State = MCP2515_STATE_IGNORE;
+        break;
+
+    case MCP2515_STATE_READ_STATUS:
+        tReturnValue = getMCP2515ReadStatus();
+        break;
+
+    case MCP2515_STATE_RX_STATUS:
+        tReturnValue = (sMCP2515Registers[MCP_CANINTF] & (MCP_RX0IF | MCP_RX1IF)) << 6;
+        break;
+
+    default:
+        break;
+    }
+    return tReturnValue;
+}
+
+/*
+ * ID of filter or mask, the EXIDE bit of a filter is checked separately
+ */
+static uint16_t getMCP2515ModelStandardId(uint8_t aSIDHAddress) {
+    return (sMCP2515Registers[aSIDHAddress] << 3) | (sMCP2515Registers[aSIDHAddress + 1] >> 5);
+}
+
+/*
+ * RXB0 uses mask 0 and filter 0 and 1, RXB1 uses mask 1 and filter 2 to 5
+ */
+static bool isAcceptedByMCP2515RXBuffer(uint8_t aBufferIndex, uint16_t aCANId) {
+    if ((sMCP2515Registers[MCP_RXB0CTRL + (aBufferIndex * 0x10)] & MCP_RXB_RX_MASK) == MCP_RXB_RX_ANY) {
+        return true;
+    }
+    static const uint8_t sFilterAddresses[] = { MCP_RXF0SIDH, MCP_RXF1SIDH, MCP_RXF2SIDH, MCP_RXF3SIDH, MCP_RXF4SIDH, MCP_RXF5SIDH };
+    uint16_t tMask = getMCP2515ModelStandardId(aBufferIndex == 0 ? MCP_RXM0SIDH : MCP_RXM1SIDH);
+    uint8_t tFirstFilter = (aBufferIndex == 0) ? 0 : 2;
+    uint8_t tLastFilter = (aBufferIndex == 0) ? 1 : 5;
+    for (uint8_t i = tFirstFilter; i <= tLastFilter; ++i) {
+        uint8_t tFilterAddress = sFilterAddresses[i];
+        if (!(sMCP2515Registers[tFilterAddress + 1] & MCP_RXB_IDE_M)
+                && ((aCANId ^ getMCP2515ModelStandardId(tFilterAddress)) & tMask) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void storeCANFrameInRXBuffer(uint8_t aBufferIndex, uint16_t aCANId, uint8_t aLength, const uint8_t *aData) {
+    uint8_t tControlAddress = MCP_RXB0CTRL + (aBufferIndex * 0x10);
+    sMCP2515Registers[tControlAddress + 1] = aCANId >> 3;
+    sMCP2515Registers[tControlAddress + 2] = aCANId << 5;
+    sMCP2515Registers[tControlAddress + 3] = 0;
+    sMCP2515Registers[tControlAddress + 4] = 0;
+    sMCP2515Registers[tControlAddress + 5] = aLength;
+    memcpy(&sMCP2515Registers[tControlAddress + 6], aData, aLength);
+    sMCP2515Registers[MCP_CANINTF] |= (MCP_RX0IF << aBufferIndex);
+    sHostIOCounters.CANFramesReceived++;
+}
+
+/*
+ * The inverter sends its 0x305 frame with 8 zero bytes periodically. The bus time of this frame is not simulated.
+ * If RXB0 is full, a frame accepted by RXB0 rolls over to RXB1, if BUKT is set.
+ */
+static void handleInverterCANFrame(uintptr_t aParameter) {
+    (void) aParameter;
+    scheduleSimulationEvent((uint64_t) sHostOptions.InverterFramePeriodMillis * 1000000, &handleInverterCANFrame, 0);
+    if ((sMCP2515Registers[MCP_CANCTRL] & MODE_MASK) != MODE_NORMAL) {
+        return;
+    }
+    const uint16_t tCANId = 0x305;
+    const uint8_t tData[8] = { 0 };
+    int8_t tBufferIndex = -1;
+    if (isAcceptedByMCP2515RXBuffer(0, tCANId)) {
+        if (!(sMCP2515Registers[MCP_CANINTF] & MCP_RX0IF)) {
+            tBufferIndex = 0;
+        } else if ((sMCP2515Registers[MCP_RXB0CTRL] & MCP_RXB_BUKT_MASK) && !(sMCP2515Registers[MCP_CANINTF] & MCP_RX1IF)) {
+            tBufferIndex = 1;
+        }
+    } else if (isAcceptedByMCP2515RXBuffer(1, tCANId)) {
+        if (!(sMCP2515Registers[MCP_CANINTF] & MCP_RX1IF)) {
+            tBufferIndex = 1;
+        }
+    } else {
+        sHostIOCounters.CANFramesRejected++;
+        return;
+    }
+    if (tBufferIndex < 0) {
+        sHostIOCounters.CANRXOverflows++;
+    } else {
+        storeCANFrameInRXBuffer(tBufferIndex, tCANId, sizeof(tData), tData);
+    }
+}
+
+void startInverterCANFrames() {
+    scheduleSimulationEvent((uint64_t) sHostOptions.InverterFramePeriodMillis * 1000000, &handleInverterCANFrame, 0);
+}
+
+uint64_t getCANLatencySum() {
+    return sCANLatencySum;
+}
+uint64_t getCANLatencyMax() {
+    return sCANLatencyMax;
+}
+uint32_t getCANLatencyCount() {
+    return sCANLatencyCount;
+}
+
+/**************************************************
+ * LCD with PCF8574 I2C expander
+ **************************************************/
+#define LCD_EXPANDER_RS_BIT         0x01
+#define LCD_EXPANDER_EN_BIT         0x04
+#define LCD_EXPANDER_BACKLIGHT_BIT  0x08
+
+static const uint8_t sLCDRowOffsets[4] = { 0x00, 0x40, 0x14, 0x54 };
+static uint8_t sLCDDDRAM[0x80];
+static uint8_t sLCDCGRAM[0x40];
+static uint8_t sLCDAddress = 0;
+static bool sLCDAddressIsCGRAM = false;
+static bool sLCDAddressIncrement = true;
+static bool sLCDIs4BitMode = false;
+static bool sLCDHasHighNibble = false;
+static uint8_t sLCDHighNibble;
+static uint8_t sLCDLastExpanderData = 0;
+static uint32_t sLCDCharacterCount = 0;
+static uint32_t sLCDCommandCount = 0;
+
+/*
+ * DDRAM addresses for 2 line mode are 0x00 to 0x27 and 0x40 to 0x67
+ */
+static uint8_t getNextLCDDDRAMAddress(uint8_t aAddress) {
+    if (sLCDAddressIncrement) {
+        aAddress++;
+        if (aAddress == 0x28) {
+            return 0x40;
+        }
+        if (aAddress >= 0x68) {
+            return 0x00;
+        }
+    } else {
+        if (aAddress == 0x40) {
+            return 0x27;
+        }
+        if (aAddress == 0x00) {
+            return 0x67;
+        }
+        aAddress--;
+    }
+    return aAddress;
+}
+
+static void executeLCDInstruction(uint8_t aInstruction) {
+    sLCDCommandCount++;
+    if (aInstruction & 0x80) {
+        sLCDAddress = aInstruction & 0x7F;
+        sLCDAddressIsCGRAM = false;
+    } else if (aInstruction & 0x40) {
+        sLCDAddress = aInstruction & 0x3F;
+        sLCDAddressIsCGRAM = true;
+    } else if (aInstruction & 0x20) {
+        // Function set, DL bit 0 means 4 bit mode
+        sLCDIs4BitMode = !(aInstruction & 0x10);
+    } else if (aInstruction & 0x10) {
+        // Cursor or display shift, only cursor move is supported
+        if (!(aInstruction & 0x08)) {
+            bool tIncrement = sLCDAddressIncrement;
+            sLCDAddressIncrement = aInstruction & 0x04;
+            sLCDAddress = getNextLCDDDRAMAddress(sLCDAddress);
+            sLCDAddressIncrement = tIncrement;
+        }
+    } else if (aInstruction & 0x04) {
+        sLCDAddressIncrement = aInstruction & 0x02;
+    } else if (aInstruction & 0x02) {
+        sLCDAddress = 0;
+        sLCDAddressIsCGRAM = false;
+    } else if (aInstruction & 0x01) {
+        memset(sLCDDDRAM, ' ', sizeof(sLCDDDRAM));
+        sLCDAddress = 0;
+        sLCDAddressIsCGRAM = false;
+        sLCDAddressIncrement = true;
+    }
+}
+
+static void writeLCDData(uint8_t aData) {
+    sLCDCharacterCount++;
+    if (sLCDAddressIsCGRAM) {
+        sLCDCGRAM[sLCDAddress & 0x3F] = aData;
+        sLCDAddress = (sLCDAddress + 1) & 0x3F;
+    } else {
+        sLCDDDRAM[sLCDAddress & 0x7F] = aData;
+        sLCDAddress = getNextLCDDDRAMAddress(sLCDAddress);
+    }
+}
+
+/*
+ * Data is taken by the HD44780 at the falling edge of EN
+ */
+void hostLCDExpanderWrite(uint8_t aData) {
+    if ((sLCDLastExpanderData & LCD_EXPANDER_EN_BIT) && !(aData & LCD_EXPANDER_EN_BIT)) {
+        uint8_t tNibble = sLCDLastExpanderData & 0xF0;
+        bool tIsData = sLCDLastExpanderData & LCD_EXPANDER_RS_BIT;
+        if (!sLCDIs4BitMode) {
+            // 8 bit mode at initialization, lower 4 data lines are not connected
+            sLCDHasHighNibble = false;
+            if (tIsData) {
+                writeLCDData(tNibble);
+            } else {
+                executeLCDInstruction(tNibble);
+            }
+        } else if (!sLCDHasHighNibble) {
+            sLCDHighNibble = tNibble;
+            sLCDHasHighNibble = true;
+        } else {
+            sLCDHasHighNibble = false;
+            uint8_t tValue = sLCDHighNibble | (tNibble >> 4);
+            if (tIsData) {
+                writeLCDData(tValue);
+            } else {
+                executeLCDInstruction(tValue);
+            }
+        }
+    }
+    sLCDLastExpanderData = aData;
+}
+
+uint32_t getLCDCharacterCount() {
+    return sLCDCharacterCount;
+}
+uint32_t getLCDCommandCount() {
+    return sLCDCommandCount;
+}
+
+/*
+ * Custom characters and characters above 0x7F are printed as '#'
+ */
+void printHostLCDScreen() {
+    printf("+--------------------+%s\n", (sLCDLastExpanderData & LCD_EXPANDER_BACKLIGHT_BIT) ? "" : " backlight off");
+    for (uint8_t tRow = 0; tRow < 4; ++tRow) {
+        putchar('|');
+        for (uint8_t tColumn = 0; tColumn < 20; ++tColumn) {
+            uint8_t tCharacter = sLCDDDRAM[sLCDRowOffsets[tRow] + tColumn];
+            putchar((tCharacter < ' ' || tCharacter > '~') ? '#' : tCharacter);
+        }
+        printf("|\n");
+    }
+    printf("+--------------------+\n");
+}
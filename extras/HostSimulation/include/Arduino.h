@@ -0,0 +1,206 @@
+/*
+ * Arduino.h
+ *
+ * Minimal Arduino core API for compiling JK-BMSToPylontechCAN.ino on a Linux host.
+ * Only the functions and macros used by the sketch and its included libraries are provided.
+ * All timing functions are based on the virtual clock of HostSimulation.h.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+/*
+ * All system headers must be included before the Arduino macros like min(), max() and abs() are defined
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "HostSimulation.h"
+#include "binary.h"
+
+#define ARDUINO 10819
+#define F_CPU   16000000L
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH    0x1
+#define LOW     0x0
+
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+
+#define A0  14
+#define A1  15
+#define A2  16
+#define A3  17
+#define A4  18
+#define A5  19
+#define LED_BUILTIN 13
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#define abs(x) ((x)>0?(x):-(x))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+/*
+ * Program memory is plain memory on the host
+ */
+#define PROGMEM
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+#define pgm_read_byte(addr)         (*(const uint8_t *)(addr))
+#define pgm_read_byte_near(addr)    pgm_read_byte(addr)
+#define pgm_read_word(addr)         (*(addr)) // Used for reading pointers from PROGMEM arrays, which are 64 bit on the host
+#define memcpy_P    memcpy
+#define strlen_P    strlen
+#define sprintf_P   sprintf
+
+#define _BV(bit)    (1 << (bit))
+#define bit_is_set(sfr, bit)    ((sfr) & _BV(bit))
+#define bit_is_clear(sfr, bit)  (!((sfr) & _BV(bit)))
+
+/*
+ * AVR register with optional read and write functions of the simulated peripheral.
+ * Each access takes one CPU cycle of virtual time, so polling loops like in HardwareSerialTX::flush() terminate.
+ * The peripheral models use Value directly, which has no side effects.
+ */
+class HostRegister {
+public:
+    constexpr HostRegister(uint8_t aValue, uint8_t (*aReadFunction)() = NULL, void (*aWriteFunction)(uint8_t aValue) = NULL) :
+            Value(aValue), ReadFunction(aReadFunction), WriteFunction(aWriteFunction) {
+    }
+    operator uint8_t();
+    HostRegister& operator=(uint8_t aValue);
+    HostRegister& operator=(HostRegister &aRegister) {
+        return *this = (uint8_t) aRegister;
+    }
+    HostRegister& operator|=(uint8_t aValue) {
+        return *this = (uint8_t) (*this | aValue);
+    }
+    HostRegister& operator&=(uint8_t aValue) {
+        return *this = (uint8_t) (*this & aValue);
+    }
+    uint8_t Value;
+    uint8_t (*ReadFunction)();
+    void (*WriteFunction)(uint8_t aValue);
+};
+
+/*
+ * Status register and USART0 of the ATmega328, used by HardwareSerialTX and the JK-BMS receive ISR
+ */
+#define SREG_I  7
+extern HostRegister SREG;
+
+#define RXC0    7
+#define TXC0    6
+#define UDRE0   5
+#define FE0     4
+#define DOR0    3
+#define UPE0    2
+#define U2X0    1
+#define MPCM0   0
+#define RXCIE0  7
+#define TXCIE0  6
+#define UDRIE0  5
+#define RXEN0   4
+#define TXEN0   3
+#define UCSZ02  2
+#define UCSZ01  2
+#define UCSZ00  1
+extern HostRegister UDR0;
+extern HostRegister UCSR0A;
+extern HostRegister UCSR0B;
+extern HostRegister UCSR0C;
+extern HostRegister UBRR0H;
+extern HostRegister UBRR0L;
+
+/*
+ * TWI of the ATmega328, used by TWI_TX.hpp
+ */
+#define TWINT   7
+#define TWEA    6
+#define TWSTA   5
+#define TWSTO   4
+#define TWWC    3
+#define TWEN    2
+#define TWIE    0
+extern HostRegister TWCR;
+extern HostRegister TWDR;
+extern HostRegister TWSR;
+extern HostRegister TWBR;
+#define SDA     A4
+#define SCL     A5
+
+/*
+ * The ISR is a plain function, which is called by the simulation if its interrupt is enabled and pending
+ */
+#define ISR(vector, ...) extern "C" void vector(void)
+
+/*
+ * AVR register emulation for the ADC reading in isVCCTooHighSimple()
+ */
+#define DEFAULT     1
+#define ADEN        7
+#define ADSC        6
+#define ADIF        4
+extern uint8_t ADMUX;
+extern uint8_t ADCSRA;
+extern uint8_t ADCL;
+extern uint8_t ADCH;
+// The conversion takes 13 ADC clocks at 125 kHz
+#define loop_until_bit_is_clear(sfr, bit) do { sfr &= ~_BV(bit); advanceSimulationNanos(104000); } while (0)
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long aMillis);
+void delayMicroseconds(unsigned int aMicros);
+
+void pinMode(uint8_t aPin, uint8_t aMode);
+void digitalWrite(uint8_t aPin, uint8_t aValue);
+int digitalRead(uint8_t aPin);
+
+void tone(uint8_t aPin, unsigned int aFrequency, unsigned long aDuration = 0);
+void noTone(uint8_t aPin);
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+char* dtostrf(double aValue, signed char aWidth, unsigned char aPrecision, char *aBuffer);
+
+void interrupts();
+void noInterrupts();
+#define sei() interrupts()
+#define cli() noInterrupts()
+
+#include "Print.h"
+
+#endif // _HOST_ARDUINO_H
@@ -0,0 +1,54 @@
+/*
+ * HostEasyButton.h
+ *
+ * Host version of the EasyButton class of EasyButtonAtInt01, which is only available for AVR.
+ * Button presses are generated by the simulation with the period given by the -b option.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#ifndef _HOST_EASY_BUTTON_H
+#define _HOST_EASY_BUTTON_H
+
+#include <stdint.h>
+
+#define EASY_BUTTON_LONG_PRESS_STILL_POSSIBLE 0
+#define EASY_BUTTON_LONG_PRESS_ABORT 1 // button was released, no long press detection possible
+#define EASY_BUTTON_LONG_PRESS_DETECTED 2
+
+#define EASY_BUTTON_LONG_PRESS_DEFAULT_MILLIS 400
+
+class EasyButton {
+public:
+    EasyButton(void (*aButtonPressCallback)(bool aButtonToggleState));
+
+    bool readButtonState();
+    bool readDebouncedButtonState();
+    uint8_t checkForLongPress(uint16_t aLongPressThresholdMillis = EASY_BUTTON_LONG_PRESS_DEFAULT_MILLIS);
+
+    volatile bool ButtonToggleState;
+    volatile bool ButtonStateIsActive;
+    volatile unsigned long ButtonLastChangeMillis;
+    void (*ButtonPressCallback)(bool aButtonToggleState);
+};
+
+void hostPressButton();
+void hostReleaseButton();
+
+#endif // _HOST_EASY_BUTTON_H
@@ -0,0 +1,136 @@
+/*
+ * HostSimulation.h
+ *
+ * Virtual clock, event queue and peripheral models for running JK-BMSToPylontechCAN.ino on a Linux host.
+ *
+ * All time is virtual and counted in nanoseconds. Blocking I/O like SPI, I2C, SoftwareSerialTX or polling of
+ * an AVR register advances the virtual clock by the time the AVR would need. Bytes arriving from the
+ * simulated JK-BMS, bytes sent by the USART or CAN transmissions finishing are events, which are processed in time order
+ * while the clock advances. The events set the interrupt flags of the USART, so its ISRs are called like on the AVR.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#ifndef _HOST_SIMULATION_H
+#define _HOST_SIMULATION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Timing of the simulated hardware, all values in nanoseconds
+ */
+#define HOST_UART_BYTE_NANOS                86806   // 10 bit at 115200 baud
+#define HOST_REGISTER_ACCESS_NANOS          63      // One CPU cycle at 16 MHz
+#define HOST_ISR_NANOS                      2000    // Interrupt response, prologue and epilogue of an ISR, which calls functions
+#define HOST_JK_BMS_REPLY_DELAY_NANOS       300000  // Reply starts 0.18 ms to 0.45 ms after request was received
+#define HOST_SPI_BYTE_NANOS                 3000    // 4 MHz SPI clock + loop overhead of SPI.transfer()
+#define HOST_SPI_TRANSACTION_NANOS          500     // SPI.beginTransaction() and SPI.endTransaction()
+#define HOST_DIGITAL_WRITE_NANOS            3500    // Arduino digitalWrite()
+#define HOST_I2C_BYTE_NANOS                 22500   // 9 bit at 400 kHz
+#define HOST_I2C_START_STOP_NANOS           2500
+#define HOST_CAN_BIT_NANOS                  2000    // 500 kBit/s
+#define HOST_LOOP_PASS_NANOS                10000   // Call of loop(), checkButtonPress() and the millis() checks of an idle loop
+
+/*
+ * Virtual clock and event queue
+ */
+uint64_t getSimulationNanos();
+void advanceSimulationNanos(uint64_t aNanos);
+void scheduleSimulationEvent(uint64_t aNanosFromNow, void (*aHandler)(uintptr_t aParameter), uintptr_t aParameter);
+void hostDelayUntil(uint64_t aNanos);
+
+/*
+ * I/O counters for the per stage statistics of the loop passes
+ */
+struct HostIOCounters {
+    uint32_t SerialRXBytesRead;         // Reads of UDR0 which returned a received byte
+    uint32_t SerialRXFramesRead;        // Reads of UDR0 which returned the last byte of a JK-BMS frame
+    uint32_t SerialRXOverruns;          // Bytes lost, because UDR0 was not read in time
+    uint32_t SerialTXBytes;             // Writes to UDR0, i.e. bytes sent
+    uint32_t SerialTXWrites;            // Bytes written to USART or TX buffer outside of ISR, i.e. by Serial.print()
+    uint32_t USARTInterrupts;           // Calls of the USART RX and data register empty ISRs
+    uint32_t TWIInterrupts;
+    uint32_t SoftwareSerialTXBytes;
+    uint32_t SPIBytes;
+    uint32_t I2CBytes;                  // Bytes sent, including the address byte
+    uint32_t I2CWrites;                 // I2C transfers started or done outside of an ISR
+    uint32_t CANFramesRequested;        // TXREQ set by software
+    uint32_t CANFramesSent;
+    uint32_t CANRetransmissions;
+    uint32_t CANFramesAborted;
+    uint32_t CANFramesReceived;         // Frames of the simulated inverter stored in a RX buffer
+    uint32_t CANFramesRejected;         // Frames of the simulated inverter dropped by the acceptance filters
+    uint32_t CANRXOverflows;            // Frames of the simulated inverter lost, because the RX buffers were not read in time
+    uint32_t ToneCalls;
+};
+extern HostIOCounters sHostIOCounters;
+
+/*
+ * Options of the simulation, set by command line
+ */
+struct HostOptions {
+    bool PrintSerialOutput;             // -o
+    bool PrintCANFrames;                // -c
+    bool DumpLCD;                       // -l
+    bool LCDIsAttached;                 // -n disables
+    bool CANIsAcknowledged;             // -a disables
+    bool VaryJKData;                    // -v
+    uint32_t TimeoutEveryNthRequest;    // -m
+    uint32_t ConfigurationChangePeriod; // -p
+    uint32_t ButtonPressPeriodMillis;   // -b
+    uint32_t ButtonPressDurationMillis; // -d
+    uint32_t InverterFramePeriodMillis; // -i
+    uint32_t SimulationSeconds;         // -t
+    double HostTimeScale;               // -s
+};
+extern HostOptions sHostOptions;
+
+/*
+ * USART RX from JK-BMS and SPI chip select, implemented in HostArduino.cpp
+ */
+void hostSerialReceiveByte(uint8_t aByte, bool aIsLastByteOfFrame);
+void hostCheckInterrupts();
+void hostSetCANChipSelectPin(uint8_t aPin);
+
+/*
+ * Peripheral models, implemented in HostPeripherals.cpp
+ */
+bool readJKBMSLogFile(const char *aFilename);
+uint16_t getNumberOfJKBMSFrames();
+const uint8_t* getJKBMSFrame(uint16_t aFrameIndex, uint16_t *aFrameSize);
+void hostJKBMSReceiveRequestByte(uint8_t aByte);
+uint32_t getJKBMSRequestCount();
+uint32_t getJKBMSReplyCount();
+uint32_t getJKBMSSuppressedReplyCount();
+uint64_t getJKBMSNanosOfLastFrameEnd();
+
+void hostMCP2515SetChipSelect(bool aIsSelected);
+uint8_t hostMCP2515Transfer(uint8_t aByte);
+uint64_t getCANLatencySum();
+uint64_t getCANLatencyMax();
+uint32_t getCANLatencyCount();
+void startInverterCANFrames();
+
+void hostLCDExpanderWrite(uint8_t aData);
+uint32_t getLCDCharacterCount();
+uint32_t getLCDCommandCount();
+void printHostLCDScreen();
+
+#endif // _HOST_SIMULATION_H
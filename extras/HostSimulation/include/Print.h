@@ -0,0 +1,81 @@
+/*
+ * Print.h
+ *
+ * Host version of the Arduino Print class with the same overloads and number formatting.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#ifndef _HOST_PRINT_H
+#define _HOST_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class __FlashStringHelper;
+
+class Print {
+private:
+    size_t printNumber(unsigned long long aNumber, uint8_t aBase);
+    size_t printFloat(double aNumber, uint8_t aDigits);
+public:
+    virtual ~Print() {
+    }
+    virtual size_t write(uint8_t aByte) = 0;
+    virtual size_t write(const uint8_t *aBuffer, size_t aSize);
+    size_t write(const char *aString) {
+        if (aString == NULL) {
+            return 0;
+        }
+        return write((const uint8_t*) aString, strlen(aString));
+    }
+    size_t write(const char *aBuffer, size_t aSize) {
+        return write((const uint8_t*) aBuffer, aSize);
+    }
+    virtual void flush() {
+    }
+
+    size_t print(const __FlashStringHelper *aPGMString);
+    size_t print(const char aString[]);
+    size_t print(char aChar);
+    size_t print(unsigned char aNumber, int aBase = 10);
+    size_t print(int aNumber, int aBase = 10);
+    size_t print(unsigned int aNumber, int aBase = 10);
+    size_t print(long aNumber, int aBase = 10);
+    size_t print(unsigned long aNumber, int aBase = 10);
+    size_t print(long long aNumber, int aBase = 10);
+    size_t print(unsigned long long aNumber, int aBase = 10);
+    size_t print(double aNumber, int aDigits = 2);
+
+    size_t println(const __FlashStringHelper *aPGMString);
+    size_t println(const char aString[]);
+    size_t println(char aChar);
+    size_t println(unsigned char aNumber, int aBase = 10);
+    size_t println(int aNumber, int aBase = 10);
+    size_t println(unsigned int aNumber, int aBase = 10);
+    size_t println(long aNumber, int aBase = 10);
+    size_t println(unsigned long aNumber, int aBase = 10);
+    size_t println(long long aNumber, int aBase = 10);
+    size_t println(unsigned long long aNumber, int aBase = 10);
+    size_t println(double aNumber, int aDigits = 2);
+    size_t println(void);
+};
+
+#endif // _HOST_PRINT_H
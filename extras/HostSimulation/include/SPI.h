@@ -0,0 +1,54 @@
+/*
+ * SPI.h
+ *
+ * Host version of the Arduino SPI library. All transfers go to the simulated MCP2515.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#ifndef _HOST_SPI_H
+#define _HOST_SPI_H
+
+#include <stdint.h>
+
+#define LSBFIRST    0
+#define MSBFIRST    1
+#define SPI_MODE0   0x00
+
+class SPISettings {
+public:
+    SPISettings(uint32_t aClock, uint8_t aBitOrder, uint8_t aDataMode) {
+        (void) aClock;
+        (void) aBitOrder;
+        (void) aDataMode;
+    }
+};
+
+class SPIClass {
+public:
+    void begin();
+    void end();
+    void beginTransaction(SPISettings aSettings);
+    uint8_t transfer(uint8_t aData);
+    void endTransaction();
+};
+
+extern SPIClass SPI;
+
+#endif // _HOST_SPI_H
@@ -0,0 +1,56 @@
+/*
+ * Wire.h
+ *
+ * Host version of the Arduino Wire library at 400 kHz. All writes to the LCD address go to the simulated PCF8574 / HD44780 LCD.
+ * The i2c_* functions of SoftI2CMaster used by JK-BMSToPylontechCAN.ino are also provided here.
+ *
+ *  Copyright (C) 2023  Armin Joachimsmeyer
+ *  Email: armin.joachimsmeyer@gmail.com
+ *
+ *  This file is part of ArduinoUtils https://github.com/ArminJo/PVUtils.
+ *
+ *  Arduino-Utils is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/gpl.html>.
+ *
+ */
+#ifndef _HOST_WIRE_H
+#define _HOST_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define HOST_LCD_I2C_ADDRESS    0x27
+#define BUFFER_LENGTH           32  // Transmit buffer size of the AVR Wire library
+
+class TwoWire {
+public:
+    void begin();
+    void setClock(uint32_t aClock);
+    void beginTransmission(uint8_t aAddress);
+    uint8_t endTransmission();
+    size_t write(uint8_t aData);
+    size_t write(int aData) {
+        return write((uint8_t) aData);
+    }
+};
+
+extern TwoWire Wire;
+
+/*
+ * SoftI2CMaster API
+ */
+bool i2c_init(void);
+bool i2c_start(uint8_t aAddressAndReadBit);
+void i2c_stop(void);
+
+#endif // _HOST_WIRE_H